@@ -308,6 +308,93 @@ void qtcShade(const Options *opts, const color *ca, color *cb, double k)
 #endif
 }
 
+/*
+  Shade one base colour by several factors at once. The base colour is only converted to HSL/HSV once, rather than
+  once per factor as repeated qtcShade() calls would do. Results are identical to calling qtcShade() for each factor.
+*/
+#ifdef __cplusplus
+void qtcShadeColors(const Options *opts, const color &ca, const double *k, int num, color *vals)
+#else
+void qtcShadeColors(const Options *opts, const color *ca, const double *k, int num, color *vals)
+#endif
+{
+    int i;
+
+    switch(opts->shading)
+    {
+        case SHADING_HSL:
+        case SHADING_HSV:
+        {
+    #ifdef __cplusplus
+            double r(ca.red()/255.0),
+                   g(ca.green()/255.0),
+                   b(ca.blue()/255.0);
+    #else
+            double r=ca->red/65535.0,
+                   g=ca->green/65535.0,
+                   b=ca->blue/65535.0;
+    #endif
+            double h, s, l;
+
+            if(SHADING_HSL==opts->shading)
+                rgbToHsl(r, g, b, &h, &s, &l);
+            else
+                qtcRgbToHsv(r, g, b, &h, &s, &l);
+
+            for(i=0; i<num; ++i)
+            {
+                double cr, cg, cb, cs, cl;
+
+                if(qtcEqual(k[i], 1.0))
+                {
+    #ifdef __cplusplus
+                    vals[i]=ca;
+    #else
+                    vals[i]=*ca;
+    #endif
+                    continue;
+                }
+
+                if(SHADING_HSL==opts->shading)
+                {
+                    cl=normalize(l*k[i]);
+                    cs=normalize(s*k[i]);
+                    hslToRgb(h, cs, cl, &cr, &cg, &cb);
+                }
+                else
+                {
+                    cs=s;
+                    cl=l*k[i];
+                    if (cl > 1.0)
+                    {
+                        cs -= cl - 1.0;
+                        if (cs < 0)
+                            cs = 0;
+                        cl = 1.0;
+                    }
+                    qtcHsvToRgb(&cr, &cg, &cb, h, cs, cl);
+                }
+    #ifdef __cplusplus
+                vals[i].setRgb(qtcLimit(cr*255.0), qtcLimit(cg*255.0), qtcLimit(cb*255.0));
+    #if defined QT_VERSION && (QT_VERSION >= 0x040000)
+                vals[i].setAlpha(ca.alpha());
+    #endif
+    #else
+                vals[i].red=qtcLimit(cr*65535.0);
+                vals[i].green=qtcLimit(cg*65535.0);
+                vals[i].blue=qtcLimit(cb*65535.0);
+                vals[i].pixel=ca->pixel;
+    #endif
+            }
+            break;
+        }
+        default:
+            /* Simple shading has no colour space conversion to share, and HCY goes via (K)ColorUtils */
+            for(i=0; i<num; ++i)
+                qtcShade(opts, ca, &vals[i], k[i]);
+    }
+}
+
 static unsigned char checkBounds(int num)
 {
     return num < 0   ? 0   :
@@ -315,6 +402,132 @@ static unsigned char checkBounds(int num)
                        num;
 }
 
+/*
+  qtcAdjustPix() recolours a mask - each pixel's colour channels become the (clamped) difference between the
+  requested colour and the pixel's second byte. For 4 channel images on x86 this is done 4 (SSE2) or 8 (AVX2)
+  pixels at a time, in 16 bit lanes so that the results are identical to the scalar code. On x86 both the Qt
+  (BGRA in memory) and GdkPixbuf (RGBA) layouts hold the source in bits 8-15, and alpha in bits 24-31, of each
+  32 bit pixel - so the same kernels serve both, only the order of the colour values differs.
+*/
+typedef void (*AdjustRowFunc)(unsigned char *data, int w, int c0, int c1, int c2);
+
+/* Any value outside of [-256, 511] gives the same result, and this keeps the 16 bit maths from overflowing */
+static inline int clampChannel(int c)
+{
+    return c < -256 ? -256 : (c > 511 ? 511 : c);
+}
+
+static void adjustRowScalar(unsigned char *data, int w, int c0, int c1, int c2)
+{
+    int x;
+
+    for(x=0; x<w; ++x, data+=4)
+    {
+        unsigned char source=data[1];
+
+        data[0] = checkBounds(c0-source);
+        data[1] = checkBounds(c1-source);
+        data[2] = checkBounds(c2-source);
+    }
+}
+
+#if (defined __x86_64__ || defined __i386__) && defined __SSE2__ && \
+    (defined __clang__ || __GNUC__ > 4 || (__GNUC__ == 4 && __GNUC_MINOR__ >= 9))
+#define QTC_X86_PIX_KERNELS
+#include <immintrin.h>
+
+static void adjustRowSse2(unsigned char *data, int w, int c0, int c1, int c2)
+{
+    const __m128i zero=_mm_setzero_si128(),
+                  cols=_mm_set_epi16(0, c2, c1, c0, 0, c2, c1, c0),
+                  sourceMask=_mm_set1_epi32(0xFF),
+                  alphaMask=_mm_set1_epi32((int)0xFF000000);
+    int           x=0;
+
+    for(; x+4<=w; x+=4, data+=16)
+    {
+        __m128i pix=_mm_loadu_si128((const __m128i *)data),
+                source=_mm_and_si128(_mm_srli_epi32(pix, 8), sourceMask),
+                lo,
+                hi;
+
+        source=_mm_or_si128(source, _mm_slli_epi32(source, 8));
+        source=_mm_or_si128(source, _mm_slli_epi32(source, 16));
+        lo=_mm_sub_epi16(cols, _mm_unpacklo_epi8(source, zero));
+        hi=_mm_sub_epi16(cols, _mm_unpackhi_epi8(source, zero));
+        _mm_storeu_si128((__m128i *)data, _mm_or_si128(_mm_andnot_si128(alphaMask, _mm_packus_epi16(lo, hi)),
+                                                      _mm_and_si128(pix, alphaMask)));
+    }
+
+    adjustRowScalar(data, w-x, c0, c1, c2);
+}
+
+__attribute__((target("avx2")))
+static void adjustRowAvx2(unsigned char *data, int w, int c0, int c1, int c2)
+{
+    /* unpack/pack work within each 128 bit lane, so the per-lane layout is as per the SSE2 version */
+    const __m256i zero=_mm256_setzero_si256(),
+                  cols=_mm256_set_epi16(0, c2, c1, c0, 0, c2, c1, c0, 0, c2, c1, c0, 0, c2, c1, c0),
+                  sourceMask=_mm256_set1_epi32(0xFF),
+                  alphaMask=_mm256_set1_epi32((int)0xFF000000);
+    int           x=0;
+
+    for(; x+8<=w; x+=8, data+=32)
+    {
+        __m256i pix=_mm256_loadu_si256((const __m256i *)data),
+                source=_mm256_and_si256(_mm256_srli_epi32(pix, 8), sourceMask),
+                lo,
+                hi;
+
+        source=_mm256_or_si256(source, _mm256_slli_epi32(source, 8));
+        source=_mm256_or_si256(source, _mm256_slli_epi32(source, 16));
+        lo=_mm256_sub_epi16(cols, _mm256_unpacklo_epi8(source, zero));
+        hi=_mm256_sub_epi16(cols, _mm256_unpackhi_epi8(source, zero));
+        _mm256_storeu_si256((__m256i *)data, _mm256_or_si256(_mm256_andnot_si256(alphaMask, _mm256_packus_epi16(lo, hi)),
+                                                            _mm256_and_si256(pix, alphaMask)));
+    }
+
+    adjustRowSse2(data, w-x, c0, c1, c2);
+}
+#endif
+
+static EPixKernel    pixKernel=PIX_KERNEL_AUTO;
+static AdjustRowFunc adjustRow=0L;
+
+EPixKernel qtcSetPixKernel(EPixKernel kernel)
+{
+#ifdef QTC_X86_PIX_KERNELS
+    int haveAvx2;
+
+    __builtin_cpu_init();
+    haveAvx2=__builtin_cpu_supports("avx2");
+
+    if(PIX_KERNEL_AUTO==kernel)
+        kernel=haveAvx2 ? PIX_KERNEL_AVX2 : PIX_KERNEL_SSE2;
+    else if(PIX_KERNEL_AVX2==kernel && !haveAvx2)
+        kernel=PIX_KERNEL_SSE2;
+#else
+    kernel=PIX_KERNEL_SCALAR;
+#endif
+
+    switch(kernel)
+    {
+#ifdef QTC_X86_PIX_KERNELS
+        case PIX_KERNEL_AVX2:
+            adjustRow=adjustRowAvx2;
+            break;
+        case PIX_KERNEL_SSE2:
+            adjustRow=adjustRowSse2;
+            break;
+#endif
+        default:
+            kernel=PIX_KERNEL_SCALAR;
+            adjustRow=adjustRowScalar;
+    }
+    pixKernel=kernel;
+    return kernel;
+}
+
 void qtcAdjustPix(unsigned char *data, int numChannels, int w, int h, int stride, int ro, int go, int bo, double shade)
 {
     int width=w*numChannels,
@@ -324,6 +537,27 @@ void qtcAdjustPix(unsigned char *data, int numChannels, int w, int h, int stride
         g=(int)((go*shade)+0.5),
         b=(int)((bo*shade)+0.5);
 
+#if !defined __cplusplus || Q_BYTE_ORDER != Q_BIG_ENDIAN
+    if(4==numChannels)
+    {
+        int c0, c1, c2;
+
+        if(!adjustRow)
+            qtcSetPixKernel(pixKernel);
+#if defined  __cplusplus
+        /* BGRA */
+        c0=b, c1=g, c2=r;
+#else
+        /* GdkPixbuf is RGBA */
+        c0=r, c1=g, c2=b;
+#endif
+        c0=clampChannel(c0), c1=clampChannel(c1), c2=clampChannel(c2);
+        for(row=0; row<h; ++row)
+            adjustRow(data+(row*stride), w, c0, c1, c2);
+        return;
+    }
+#endif
+
     for(row=0; row<h; ++row)
     {
         int column;
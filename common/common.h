@@ -1294,10 +1294,21 @@ extern void qtcRgbToHsv(double r, double g, double b, double *h, double *s, doub
 extern void qtcRgbToHsv(double r, double g, double b, double *h, double *s, double *v);
 #ifdef __cplusplus
 extern void qtcShade(const Options *opts, const color &ca, color *cb, double k);
+extern void qtcShadeColors(const Options *opts, const color &ca, const double *k, int num, color *vals);
 #else
 extern void qtcShade(const Options *opts, const color *ca, color *cb, double k);
+extern void qtcShadeColors(const Options *opts, const color *ca, const double *k, int num, color *vals);
 #endif
 
+typedef enum
+{
+    PIX_KERNEL_AUTO,
+    PIX_KERNEL_SCALAR,
+    PIX_KERNEL_SSE2,
+    PIX_KERNEL_AVX2
+} EPixKernel;
+
+extern EPixKernel qtcSetPixKernel(EPixKernel kernel);
 extern void qtcAdjustPix(unsigned char *data, int numChannels, int w, int h, int stride, int ro, int go, int bo, double shade);
 extern void qtcSetupGradient(Gradient *grad, EGradientBorder border, int numStops, ...);
 extern const Gradient * qtcGetGradient(EAppearance app, const Options *opts);
@@ -899,39 +899,53 @@ void qtcSetBarHidden(const char *app, bool hidden, const char *prefix)
 #ifdef __cplusplus
 #include <QtSvg/QSvgRenderer>
 #include <QtGui/QPainter>
-#endif // __cplusplus
+#include <QtGui/QImage>
 
-void qtcLoadBgndImage(QtCImage *img)
+QString qtcBgndImageFile(const QString &file)
 {
-    if(!img->loaded &&
-        ( (img->width>16 && img->width<1024 && img->height>16 && img->height<1024) || (0==img->width && 0==img->height)) )
-    {
-        img->loaded=true;
-#ifdef __cplusplus
-        img->pixmap.img=QPixmap();
-        QString file(determineFileName(img->pixmap.file));
+    return file.isEmpty() ? QString() : determineFileName(file);
+}
+
+// Only uses QImage (and not QPixmap), so that this may be called from a worker thread.
+QImage qtcRenderBgndImage(const QString &file, int width, int height)
+{
+    QImage img;
 
-        if(!file.isEmpty())
+    if(!file.isEmpty())
+    {
+        if(0!=width && (file.endsWith(".svg", Qt::CaseInsensitive) || file.endsWith(".svgz", Qt::CaseInsensitive)))
         {
-            bool loaded=false;
-            if(0!=img->width && (file.endsWith(".svg", Qt::CaseInsensitive) || file.endsWith(".svgz", Qt::CaseInsensitive)))
-            {
-                QSvgRenderer svg(file);
+            QSvgRenderer svg(file);
 
-                if(svg.isValid())
-                {
-                    img->pixmap.img=QPixmap(img->width, img->height);
-                    img->pixmap.img.fill(Qt::transparent);
-                    QPainter painter(&img->pixmap.img);
-                    svg.render(&painter);
-                    painter.end();
-                    loaded=true;
-                }
+            if(svg.isValid())
+            {
+                img=QImage(width, height, QImage::Format_ARGB32_Premultiplied);
+                img.fill(0);
+                QPainter painter(&img);
+                svg.render(&painter);
+                painter.end();
+                return img;
             }
-            if(!loaded && img->pixmap.img.load(file) && 0!=img->width &&
-               (img->pixmap.img.height()!=img->height || img->pixmap.img.width()!=img->width))
-                img->pixmap.img=img->pixmap.img.scaled(img->width, img->height, Qt::IgnoreAspectRatio, Qt::SmoothTransformation);
         }
+        if(img.load(file) && 0!=width && (img.height()!=height || img.width()!=width))
+            img=img.scaled(width, height, Qt::IgnoreAspectRatio, Qt::SmoothTransformation);
+    }
+    return img;
+}
+#endif // __cplusplus
+
+bool qtcBgndImageSizeValid(const QtCImage *img)
+{
+    return (img->width>16 && img->width<1024 && img->height>16 && img->height<1024) || (0==img->width && 0==img->height);
+}
+
+void qtcLoadBgndImage(QtCImage *img)
+{
+    if(!img->loaded && qtcBgndImageSizeValid(img))
+    {
+        img->loaded=true;
+#ifdef __cplusplus
+        img->pixmap.img=QPixmap::fromImage(qtcRenderBgndImage(qtcBgndImageFile(img->pixmap.file), img->width, img->height));
 #else // __cplusplus
         img->pixmap.img=0L;
         if(img->pixmap.file)
@@ -957,83 +971,207 @@ static void checkColor(EShade *s, color *c)
         *s=SHADE_NONE;
 }
 
-#ifdef __cplusplus
+/*
+ * Config file entries are held in an open-addressed hash table (linear probing, FNV-1a hashes), whose keys and
+ * values point directly into a copy of the file. The file is tokenized in a single pass, with each key and value
+ * NUL-terminated in place - so there are no per-line, or per-entry, allocations. As with the previous parsers, lines
+ * without '=' (e.g. section headers) are ignored, and later entries replace earlier ones.
+ *
+ * The file is read into a buffer, rather than mapped, as editors (and kwriteconfig) may truncate and rewrite it in
+ * place whilst it is being parsed - which would give SIGBUS for a mapping. It is small enough that one read is just
+ * as quick.
+ */
+typedef struct
+{
+    const char   *key,
+                 *val;
+    unsigned int hash;
+} CfgEntry;
 
-class QtCConfig
+typedef struct
 {
-    public:
+    char         *data;
+    size_t       size;
+    CfgEntry     *entries;
+    unsigned int mask;
+    int          count;
+} CfgTable;
 
-    QtCConfig(const QString &filename);
+#define CFG_INITIAL_SIZE 512
 
-    bool            ok() const { return values.count()>0; }
-    bool            hasKey(const QString &key) { return values.contains(key); }
-    const QString & readEntry(const QString &key, const QString &def=QString::null);
+static unsigned int cfgHash(const char *key)
+{
+    unsigned int hash=2166136261u;
 
-    private:
+    for(; *key; ++key)
+        hash=(hash^(unsigned char)*key)*16777619u;
+    return hash;
+}
 
-    QMap<QString, QString> values;
-};
+static CfgEntry * cfgSlot(CfgEntry *entries, unsigned int mask, const char *key, unsigned int hash)
+{
+    unsigned int i=hash&mask;
 
-QtCConfig::QtCConfig(const QString &filename)
+    /* Table is never more than half full, so this always terminates */
+    for(;; i=(i+1)&mask)
+        if(!entries[i].key || (entries[i].hash==hash && 0==strcmp(entries[i].key, key)))
+            return &entries[i];
+}
+
+static void cfgInsert(CfgTable *tbl, const char *key, const char *val)
 {
-    QFile f(filename);
+    unsigned int hash=cfgHash(key);
+    CfgEntry     *entry;
 
-#if QT_VERSION >= 0x040000
-    if(f.open(QIODevice::ReadOnly))
-#else
-    if(f.open(IO_ReadOnly))
-#endif
+    if((unsigned int)(tbl->count+1)*2>tbl->mask+1)
     {
-        QTextStream stream(&f);
-        QString     line;
+        unsigned int newMask=((tbl->mask+1)*2)-1,
+                     i;
+        CfgEntry     *entries=(CfgEntry *)calloc(newMask+1, sizeof(CfgEntry));
+
+        for(i=0; i<=tbl->mask; ++i)
+            if(tbl->entries[i].key)
+                *cfgSlot(entries, newMask, tbl->entries[i].key, tbl->entries[i].hash)=tbl->entries[i];
+        free(tbl->entries);
+        tbl->entries=entries;
+        tbl->mask=newMask;
+    }
+
+    entry=cfgSlot(tbl->entries, tbl->mask, key, hash);
+    if(!entry->key)
+        tbl->count++;
+    entry->key=key;
+    entry->val=val;
+    entry->hash=hash;
+}
+
+static const char * cfgLookup(const CfgTable *tbl, const char *key)
+{
+    return tbl->entries ? cfgSlot(tbl->entries, tbl->mask, key, cfgHash(key))->val : NULL;
+}
 
-        while(!stream.atEnd())
+static void cfgFree(CfgTable *tbl)
+{
+    free(tbl->data);
+    free(tbl->entries);
+    memset(tbl, 0, sizeof(CfgTable));
+}
+
+static bool cfgLoad(CfgTable *tbl, const char *filename)
+{
+    struct stat info;
+    FILE        *f=NULL;
+    char        *line,
+                *end;
+
+    memset(tbl, 0, sizeof(CfgTable));
+
+    if(0!=stat(filename, &info) || info.st_size<=0)
+        return false;
+
+    /* If the file is changed after the stat(), fewer bytes may be read - or the tail of a longer file is ignored, as
+       it will be re-read when the change is noticed. */
+    tbl->size=info.st_size;
+    tbl->data=(char *)malloc(tbl->size+1);
+    if(tbl->data && (f=fopen(filename, "rb")))
+    {
+        tbl->size=fread(tbl->data, 1, tbl->size, f);
+        tbl->data[tbl->size]='\0';
+        fclose(f);
+    }
+    else
+    {
+        cfgFree(tbl);
+        return false;
+    }
+
+    tbl->mask=CFG_INITIAL_SIZE-1;
+    tbl->entries=(CfgEntry *)calloc(CFG_INITIAL_SIZE, sizeof(CfgEntry));
+
+    for(line=tbl->data, end=tbl->data+tbl->size; line<end; )
+    {
+        char *eol=(char *)memchr(line, '\n', end-line),
+             *eq=(char *)memchr(line, '=', (eol ? eol : end)-line);
+
+        if(eol)
         {
-            line = stream.readLine();
-#if QT_VERSION >= 0x040000
-            int pos=line.indexOf('=');
-#else
-            int pos=line.find('=');
-#endif
-            if(-1!=pos)
-                values[line.left(pos)]=line.mid(pos+1);
+            *eol='\0';
+            if(eol>line && '\r'==eol[-1])
+                eol[-1]='\0';
         }
-        f.close();
+        if(eq)
+        {
+            *eq='\0';
+            cfgInsert(tbl, line, eq+1);
+        }
+        line=eol ? eol+1 : end;
     }
+
+    return true;
 }
 
-inline const QString & QtCConfig::readEntry(const QString &key, const QString &def)
+#ifdef __cplusplus
+
+class QtCConfig
 {
-    return values.contains(key) ? values[key] : def;
-}
+    public:
+
+    QtCConfig(const QString &filename) { cfgLoad(&itsTable, QFile::encodeName(filename).data()); }
+    ~QtCConfig()                       { cfgFree(&itsTable); }
+
+    bool         ok() const                      { return itsTable.count>0; }
+    bool         hasKey(const char *key) const   { return NULL!=cfgLookup(&itsTable, key); }
+    const char * rawEntry(const char *key) const { return cfgLookup(&itsTable, key); }
+    QString      readEntry(const char *key, const QString &def=QString::null) const
+    {
+        const char *val=cfgLookup(&itsTable, key);
+
+        return val ? QString::fromLocal8Bit(val) : def;
+    }
 
-inline QString readStringEntry(QtCConfig &cfg, const QString &key)
+    private:
+
+    CfgTable itsTable;
+};
+
+inline QString readStringEntry(QtCConfig &cfg, const char *key)
 {
     return cfg.readEntry(key);
 }
 
-static int readNumEntry(QtCConfig &cfg, const QString &key, int def)
+// The numeric and boolean readers work on the raw value, so that they do not need to create a QString
+
+static int readNumEntry(QtCConfig &cfg, const char *key, int def)
 {
-    const QString &val(readStringEntry(cfg, key));
+    const char *val=cfg.rawEntry(key);
 
-    return val.isEmpty() ? def : val.toInt();
+    if(!val || '\0'==val[0])
+        return def;
+
+    // As per QString::toInt() - anything other than a whole number gives 0
+    char *end=NULL;
+    long num=strtol(val, &end, 10);
+
+    while(end && isspace(*end))
+        end++;
+    return end && '\0'==*end ? (int)num : 0;
 }
 
-static int readVersionEntry(QtCConfig &cfg, const QString &key)
+static int readVersionEntry(QtCConfig &cfg, const char *key)
 {
-    const QString &val(readStringEntry(cfg, key));
-    int           major, minor, patch;
+    const char *val=cfg.rawEntry(key);
+    int        major, minor, patch;
 
-    return !val.isEmpty() && 3==sscanf(TO_LATIN1(val), "%d.%d.%d", &major, &minor, &patch)
+    return val && 3==sscanf(val, "%d.%d.%d", &major, &minor, &patch)
             ? MAKE_VERSION3(major, minor, patch)
             : 0;
 }
 
-static bool readBoolEntry(QtCConfig &cfg, const QString &key, bool def)
+static bool readBoolEntry(QtCConfig &cfg, const char *key, bool def)
 {
-    const QString &val(readStringEntry(cfg, key));
+    const char *val=cfg.rawEntry(key);
 
-    return val.isEmpty() ? def : (val=="true" ? true : false);
+    return !val || '\0'==val[0] ? def : 0==strcmp(val, "true");
 }
 
 static void readDoubleList(QtCConfig &cfg, const char *key, double *list, int count)
@@ -1108,75 +1246,39 @@ static void readDoubleList(QtCConfig &cfg, const char *key, double *list, int co
 
 #else
 
-static char * lookupCfgHash(GHashTable **cfg, char *key, char *val)
-{
-    char *rv=NULL;
-
-    if(!*cfg)
-        *cfg=g_hash_table_new(g_str_hash, g_str_equal);
-    else
-        rv=(char *)g_hash_table_lookup(*cfg, key);
-
-    if(!rv && val)
-    {
-        g_hash_table_insert(*cfg, g_strdup(key), g_strdup(val));
-        rv=(char *)g_hash_table_lookup(*cfg, key);
-    }
-
-    return rv;
-}
-
-static GHashTable * loadConfig(const char *filename)
+static CfgTable * loadConfig(const char *filename)
 {
-    FILE       *f=fopen(filename, "r");
-    GHashTable *cfg=NULL;
+    CfgTable *cfg=(CfgTable *)malloc(sizeof(CfgTable));
 
-    if(f)
+    if(cfg && (!cfgLoad(cfg, filename) || 0==cfg->count))
     {
-        char line[MAX_CONFIG_INPUT_LINE_LEN];
-
-        while(NULL!=fgets(line, MAX_CONFIG_INPUT_LINE_LEN-1, f))
-        {
-            char *eq=strchr(line, '=');
-            int  pos=eq ? eq-line : -1;
-
-            if(pos>0)
-            {
-                char *endl=strchr(line, '\n');
-
-                if(endl)
-                    *endl='\0';
-
-                line[pos]='\0';
-
-                lookupCfgHash(&cfg, line, &line[pos+1]);
-            }
-        }
-
-        fclose(f);
+        cfgFree(cfg);
+        free(cfg);
+        cfg=NULL;
     }
 
     return cfg;
 }
 
-static void releaseConfig(GHashTable *cfg)
+static void releaseConfig(CfgTable *cfg)
 {
-    g_hash_table_destroy(cfg);
+    cfgFree(cfg);
+    free(cfg);
 }
 
-static char * readStringEntry(GHashTable *cfg, char *key)
+static char * readStringEntry(CfgTable *cfg, char *key)
 {
-    return lookupCfgHash(&cfg, key, NULL);
+    return (char *)cfgLookup(cfg, key);
 }
 
-static int readNumEntry(GHashTable *cfg, char *key, int def)
+static int readNumEntry(CfgTable *cfg, char *key, int def)
 {
     char *str=readStringEntry(cfg, key);
 
     return str ? atoi(str) : def;
 }
 
-static int readVersionEntry(GHashTable *cfg, char *key)
+static int readVersionEntry(CfgTable *cfg, char *key)
 {
     char *str=readStringEntry(cfg, key);
     int  major, minor, patch;
@@ -1186,14 +1288,14 @@ static int readVersionEntry(GHashTable *cfg, char *key)
             : 0;
 }
 
-static gboolean readBoolEntry(GHashTable *cfg, char *key, gboolean def)
+static gboolean readBoolEntry(CfgTable *cfg, char *key, gboolean def)
 {
     char *str=readStringEntry(cfg, key);
 
     return str ? (0==memcmp(str, "true", 4) ? true : false) : def;
 }
 
-static void readDoubleList(GHashTable *cfg, char *key, double *list, int count)
+static void readDoubleList(CfgTable *cfg, char *key, double *list, int count)
 {
     char *str=readStringEntry(cfg, key);
 
@@ -1693,6 +1795,281 @@ void qtcCheckConfig(Options *opts)
 }
 
 #ifdef __cplusplus
+QString qtcConfigFile()
+{
+    const char *env=getenv("QTCURVE_CONFIG_FILE");
+
+    if(NULL!=env)
+        return env;
+    else
+    {
+        const char *cfgDir=qtcConfDir();
+
+        if(cfgDir)
+        {
+            QString filename(QFile::decodeName(cfgDir)+CONFIG_FILE);
+
+            if(!QFile::exists(filename))
+                filename=QFile::decodeName(cfgDir)+"../"OLD_CONFIG_FILE;
+            return filename;
+        }
+    }
+    return QString();
+}
+
+#if QT_VERSION >= 0x040000
+// Binary snapshot of the Options resolved from a config file. Parsing the text file, and then the hundreds of
+// string lookups, is a noticeable part of style load time - so the result is stored, and re-used for as long as
+// the config file's contents match. (Size and modification time are not enough - a same-size edit saved within
+// the same second would be missed, and the file is small enough to simply hash.) What the parser resolves also
+// depends upon whether the background image files exist, so these are stored, and checked, too. The plain-old-data
+// members are stored as raw bytes, so a snapshot is only valid for the exact same layout of Options.
+#include <QtCore/QCoreApplication>
+#include <QtCore/QCryptographicHash>
+#include <QtCore/QDataStream>
+#include <QtCore/QDateTime>
+#include <QtCore/QDir>
+#include <QtCore/QFileInfo>
+#include <QtGui/QColor>
+
+static const quint32 constSnapshotMagic   = 0x51544353; // 'QTCS'
+static const quint32 constSnapshotVersion = 3;
+
+static QString snapshotFile(const QString &file)
+{
+    return QFile::decodeName(qtcConfDir())+QString().sprintf("cache/config-%08x.bin", qHash(file));
+}
+
+// The members that cannot be stored as raw bytes split Options into two POD regions...
+static int podRegion1Size(const Options *opts)
+{
+    return (const char *)&opts->titlebarButtonColors-(const char *)opts;
+}
+
+static int podRegion2Offset(const Options *opts)
+{
+    return (const char *)&opts->titlebarIcon-(const char *)opts;
+}
+
+static int podRegion2Size(const Options *opts)
+{
+    return (const char *)&opts->customGradient-(const char *)&opts->titlebarIcon;
+}
+
+static void writeImage(QDataStream &str, const QtCImage &img)
+{
+    str << (qint32)img.type << img.onBorder << img.pixmap.file << (qint32)img.width << (qint32)img.height
+        << (qint32)img.pos;
+}
+
+static void readImage(QDataStream &str, QtCImage &img)
+{
+    qint32 type, width, height, pos;
+
+    str >> type >> img.onBorder >> img.pixmap.file >> width >> height >> pos;
+    img.type=(EImageType)type;
+    img.loaded=false;
+    img.width=width;
+    img.height=height;
+    img.pos=(EPixPos)pos;
+}
+
+static QByteArray configHash(const QString &file)
+{
+    QFile f(file);
+
+    return f.open(QIODevice::ReadOnly) ? QCryptographicHash::hash(f.readAll(), QCryptographicHash::Md5) : QByteArray();
+}
+
+static void writeHeader(QDataStream &str, const QString &file, const QByteArray &hash, const Options *opts)
+{
+    str << constSnapshotMagic << constSnapshotVersion
+#ifdef VERSION
+        << QString(VERSION)
+#else
+        << QString()
+#endif
+        << (quint32)sizeof(Options) << (quint32)podRegion1Size(opts) << (quint32)podRegion2Offset(opts)
+        << (quint32)podRegion2Size(opts) << file << hash;
+}
+
+// The state of the image files referenced by the "file:" appearances (see toAppearance()), as written into the
+// snapshot. This is taken before the config is parsed, so that it describes the images that the parser saw.
+static QByteArray snapshotImages(const QtCConfig &cfg)
+{
+    static const char * constKeys[]={ "bgndAppearance", "menuBgndAppearance", 0L };
+
+    QStringList images;
+    QByteArray  data;
+    QDataStream str(&data, QIODevice::WriteOnly);
+
+    for(int i=0; constKeys[i]; ++i)
+    {
+        const char *val=cfg.rawEntry(constKeys[i]);
+
+        if(val && 0==memcmp(val, "file", 4) && strlen(val)>9)
+            images.append(determineFileName(&val[5]));
+    }
+
+    str << (quint32)images.count();
+    for(QStringList::ConstIterator it(images.begin()); it!=images.end(); ++it)
+    {
+        QFileInfo info(*it);
+
+        str << *it << info.exists() << (qint64)info.size() << (quint32)info.lastModified().toTime_t();
+    }
+    return data;
+}
+
+static bool readSnapshot(const QString &file, const QByteArray &hash, Options *opts)
+{
+    QFile f(snapshotFile(file));
+
+    if(hash.isEmpty() || !f.open(QIODevice::ReadOnly))
+        return false;
+
+    QByteArray  data(f.readAll()),
+                expected;
+    QDataStream hdr(&expected, QIODevice::WriteOnly);
+
+    writeHeader(hdr, file, hash, opts);
+
+    if(!data.startsWith(expected))
+        return false;
+
+    QDataStream str(data);
+    Options     snap;
+
+    str.skipRawData(expected.size());
+
+    // If an image has appeared, disappeared, or changed, then the parser may now resolve a different appearance...
+    quint32 numImages;
+
+    str >> numImages;
+    for(quint32 i=0; i<numImages && QDataStream::Ok==str.status(); ++i)
+    {
+        QString image;
+        bool    exists;
+        qint64  size;
+        quint32 modified;
+
+        str >> image >> exists >> size >> modified;
+
+        QFileInfo info(image);
+
+        if(exists!=info.exists() || size!=info.size() || modified!=info.lastModified().toTime_t())
+            return false;
+    }
+
+    if(str.readRawData((char *)&snap, podRegion1Size(opts))!=podRegion1Size(opts) ||
+       str.readRawData(((char *)&snap)+podRegion2Offset(opts), podRegion2Size(opts))!=podRegion2Size(opts))
+        return false;
+
+    quint32 count;
+
+    str >> count;
+    for(quint32 i=0; i<count && QDataStream::Ok==str.status(); ++i)
+    {
+        qint32 btn;
+        QColor col;
+
+        str >> btn >> col;
+        snap.titlebarButtonColors[btn]=col;
+    }
+
+    str >> count;
+    for(quint32 i=0; i<count && QDataStream::Ok==str.status(); ++i)
+    {
+        qint32   app,
+                 border;
+        quint32  numStops;
+        Gradient grad;
+
+        str >> app >> border >> numStops;
+        grad.border=(EGradientBorder)border;
+        for(quint32 s=0; s<numStops && QDataStream::Ok==str.status(); ++s)
+        {
+            double pos, val, alpha;
+
+            str >> pos >> val >> alpha;
+            grad.stops.insert(GradientStop(pos, val, alpha));
+        }
+        snap.customGradient[(EAppearance)app]=grad;
+    }
+
+    str >> snap.bgndPixmap.file >> snap.menuBgndPixmap.file;
+    readImage(str, snap.bgndImage);
+    readImage(str, snap.menuBgndImage);
+    str >> snap.noBgndGradientApps >> snap.noBgndOpacityApps >> snap.noMenuBgndOpacityApps >> snap.noBgndImageApps
+#ifdef QTC_ENABLE_PARENTLESS_DIALOG_FIX_SUPPORT
+        >> snap.noDlgFixApps
+#endif
+        >> snap.noMenuStripeApps >> snap.menubarApps >> snap.statusbarApps >> snap.useQtFileDialogApps
+        >> snap.windowDragWhiteList >> snap.windowDragBlackList;
+
+    if(QDataStream::Ok!=str.status() || !str.atEnd())
+        return false;
+
+    // The text parser only sets APPEARANCE_FILE if the image loads - so if it no longer does, re-parse.
+    if((APPEARANCE_FILE==snap.bgndAppearance && !snap.bgndPixmap.img.load(snap.bgndPixmap.file)) ||
+       (APPEARANCE_FILE==snap.menuBgndAppearance && !snap.menuBgndPixmap.img.load(snap.menuBgndPixmap.file)))
+        return false;
+
+    *opts=snap;
+    return true;
+}
+
+static void writeSnapshot(const QString &file, const QByteArray &hash, const QByteArray &images, const Options *opts)
+{
+    QString     snapFile(snapshotFile(file));
+    QByteArray  data;
+    QDataStream str(&data, QIODevice::WriteOnly);
+
+    if(hash.isEmpty() || !QDir().mkpath(QFileInfo(snapFile).absolutePath()))
+        return;
+
+    writeHeader(str, file, hash, opts);
+    str.writeRawData(images.constData(), images.size());
+    str.writeRawData((const char *)opts, podRegion1Size(opts));
+    str.writeRawData(((const char *)opts)+podRegion2Offset(opts), podRegion2Size(opts));
+
+    str << (quint32)opts->titlebarButtonColors.size();
+    for(TBCols::const_iterator it(opts->titlebarButtonColors.begin()); it!=opts->titlebarButtonColors.end(); ++it)
+        str << (qint32)(*it).first << (*it).second;
+
+    str << (quint32)opts->customGradient.size();
+    for(GradientCont::const_iterator it(opts->customGradient.begin()); it!=opts->customGradient.end(); ++it)
+    {
+        str << (qint32)(*it).first << (qint32)(*it).second.border << (quint32)(*it).second.stops.size();
+        for(GradientStopCont::const_iterator s((*it).second.stops.begin()); s!=(*it).second.stops.end(); ++s)
+            str << (*s).pos << (*s).val << (*s).alpha;
+    }
+
+    str << opts->bgndPixmap.file << opts->menuBgndPixmap.file;
+    writeImage(str, opts->bgndImage);
+    writeImage(str, opts->menuBgndImage);
+    str << opts->noBgndGradientApps << opts->noBgndOpacityApps << opts->noMenuBgndOpacityApps << opts->noBgndImageApps
+#ifdef QTC_ENABLE_PARENTLESS_DIALOG_FIX_SUPPORT
+        << opts->noDlgFixApps
+#endif
+        << opts->noMenuStripeApps << opts->menubarApps << opts->statusbarApps << opts->useQtFileDialogApps
+        << opts->windowDragWhiteList << opts->windowDragBlackList;
+
+    // Several processes may start at once - write to a temporary file, and rename, so that none sees a partial file
+    QString tmpFile(snapFile+QString().sprintf(".%lld", (long long)QCoreApplication::applicationPid()));
+    QFile   f(tmpFile);
+
+    if(f.open(QIODevice::WriteOnly))
+    {
+        bool ok=f.write(data)==data.size();
+
+        f.close();
+        if(!ok || 0!=rename(QFile::encodeName(tmpFile).constData(), QFile::encodeName(snapFile).constData()))
+            QFile::remove(tmpFile);
+    }
+}
+#endif // QT_VERSION >= 0x040000
+
 bool qtcReadConfig(const QString &file, Options *opts, Options *defOpts, bool checkImages)
 #else
 bool qtcReadConfig(const char *file, Options *opts, Options *defOpts)
@@ -1701,23 +2078,10 @@ bool qtcReadConfig(const char *file, Options *opts, Options *defOpts)
 #ifdef __cplusplus
     if(file.isEmpty())
     {
-        const char *env=getenv("QTCURVE_CONFIG_FILE");
+        QString filename(qtcConfigFile());
 
-        if(NULL!=env)
-            return qtcReadConfig(env, opts, defOpts);
-        else
-        {
-            const char *cfgDir=qtcConfDir();
-
-            if(cfgDir)
-            {
-                QString filename(QFile::decodeName(cfgDir)+CONFIG_FILE);
-
-                if(!QFile::exists(filename))
-                    filename=QFile::decodeName(cfgDir)+"../"OLD_CONFIG_FILE;
-                return qtcReadConfig(filename, opts, defOpts);
-            }
-        }
+        if(!filename.isEmpty())
+            return qtcReadConfig(filename, opts, defOpts);
     }
 #else
     bool checkImages=true;
@@ -1749,12 +2113,25 @@ bool qtcReadConfig(const char *file, Options *opts, Options *defOpts)
     else
     {
 #ifdef __cplusplus
+#if QT_VERSION >= 0x040000
+        // Snapshots are only for the plain read of the current settings - not for imports in the config dialog
+        // The hash is taken before parsing, so that the snapshot describes exactly the contents that were parsed -
+        // even if the file is changed while this is happening.
+        bool       useSnapshot=!defOpts && checkImages;
+        QByteArray hash(useSnapshot ? configHash(file) : QByteArray());
+
+        if(useSnapshot && readSnapshot(file, hash, opts))
+            return true;
+#endif
         QtCConfig cfg(file);
+#if QT_VERSION >= 0x040000
+        QByteArray images(useSnapshot && cfg.ok() ? snapshotImages(cfg) : QByteArray());
+#endif
 
         if(cfg.ok())
         {
 #else
-        GHashTable *cfg=loadConfig(file);
+        CfgTable *cfg=loadConfig(file);
 
         if(cfg)
         {
@@ -2214,9 +2591,9 @@ bool qtcReadConfig(const char *file, Options *opts, Options *defOpts)
 
             for(i=APPEARANCE_CUSTOM1; i<(APPEARANCE_CUSTOM1+NUM_CUSTOM_GRAD); ++i)
             {
-                QString gradKey;
+                char gradKey[18];
 
-                gradKey.sprintf("customgradient%d", (i-APPEARANCE_CUSTOM1)+1);
+                sprintf(gradKey, "customgradient%d", (i-APPEARANCE_CUSTOM1)+1);
 
 #if (defined QT_VERSION && (QT_VERSION >= 0x040000))
                 QStringList vals(readStringEntry(cfg, gradKey).split(',', QString::SkipEmptyParts));
@@ -2395,6 +2772,10 @@ bool qtcReadConfig(const char *file, Options *opts, Options *defOpts)
 
             qtcCheckConfig(opts);
 
+#if defined __cplusplus && QT_VERSION >= 0x040000
+            if(useSnapshot)
+                writeSnapshot(file, hash, images, opts);
+#endif
 #ifndef __cplusplus
             if(!defOpts)
             {
@@ -24,7 +24,13 @@ extern gboolean qtcBarHidden(const char *app, const char *prefix);
 extern void qtcSetBarHidden(const char *app, bool hidden, const char *prefix);
 #endif // __cplusplus
 
+extern bool qtcBgndImageSizeValid(const QtCImage *img);
 extern void qtcLoadBgndImage(QtCImage *img);
+#ifdef __cplusplus
+class QImage;
+extern QString qtcBgndImageFile(const QString &file);
+extern QImage qtcRenderBgndImage(const QString &file, int width, int height);
+#endif // __cplusplus
 
 #endif // !defined QT_VERSION || QT_VERSION >= 0x040000)
 
@@ -34,6 +40,8 @@ extern void qtcSetRgb(color *col, const char *str);
 extern void qtcDefaultSettings(Options *opts);
 extern void qtcCheckConfig(Options *opts);
 #ifdef __cplusplus
+// The file read by qtcReadConfig() when it is passed an empty file name
+extern QString qtcConfigFile();
 extern bool qtcReadConfig(const QString &file, Options *opts, Options *defOpts=0L, bool checkImages=true);
 extern WindowBorders qtcGetWindowBorderSize(bool force=false);
 #else
@@ -10,5 +10,8 @@
 #cmakedefine QTC_STYLE_SUPPORT
 #cmakedefine QTC_KWIN_MAX_BUTTON_HACK
 #cmakedefine QTC_ENABLE_PARENTLESS_DIALOG_FIX_SUPPORT
+#cmakedefine QTC_ENABLE_DISK_TILE_CACHE
+#cmakedefine QTC_ENABLE_SHARED_TILE_CACHE
+#cmakedefine QTC_HAVE_XFIXES
 
 #endif
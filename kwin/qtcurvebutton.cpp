@@ -154,9 +154,19 @@ void QtCurveButton::paintEvent(QPaintEvent *ev)
 //                   (a.blue()+limit(b.blue()*factor))>>1);
 // }
 
+// Key for the handler's cache of rendered buttons. The colours, and the style's settings, are not part of this - as
+// the cache is cleared whenever these change.
+static quint64 buttonKey(int type, int icon, const QSize &size, bool active, bool hover, bool sunken, bool enabled,
+                         bool toolWindow)
+{
+    return (((quint64)(type&0xFF))<<40)|(((quint64)(icon&0xFF))<<32)|
+           (((quint64)(size.width()&0xFFF))<<20)|(((quint64)(size.height()&0xFFF))<<8)|
+           (active ? 0x01 : 0)|(hover ? 0x02 : 0)|(sunken ? 0x04 : 0)|(enabled ? 0x08 : 0)|(toolWindow ? 0x10 : 0);
+}
+
 void QtCurveButton::drawButton(QPainter *painter)
 {
-    int  flags=Handler()->wStyle()->pixelMetric((QStyle::PixelMetric)QtC_TitleBarButtons, 0L, 0L);
+    int  flags=Handler()->styleMetrics().titleBarButtons;
     bool active(itsClient->isActive());
 
     if(!active && !itsHover && flags&TITLEBAR_BUTTOM_HIDE_ON_INACTIVE_WINDOW)
@@ -169,7 +179,24 @@ void QtCurveButton::drawButton(QPainter *painter)
                        (itsHover || sunken || !(flags&TITLEBAR_BUTTON_HOVER_FRAME))),
              drewFrame(false),
              iconForMenu(TITLEBAR_ICON_MENU_BUTTON==
-                            Handler()->wStyle()->pixelMetric((QStyle::PixelMetric)QtC_TitleBarIcon, 0L, 0L));
+                            Handler()->styleMetrics().titleBarIcon);
+    // The menu button's icon comes from the window, so is not cached.
+    bool     cache(MenuButton!=type() || !iconForMenu);
+    quint64  key(cache ? buttonKey(type(), itsIconType, size(), active, itsHover, sunken, isEnabled(),
+                                   itsClient->isToolWindow())
+                       : 0);
+
+    if(cache)
+    {
+        const QPixmap *cached(Handler()->cachedButton(key));
+
+        if(cached)
+        {
+            painter->drawPixmap(0, 0, *cached);
+            return;
+        }
+    }
+
     QColor   buttonColor(KDecoration::options()->color(KDecoration::ColorTitleBar, active));
     QPixmap  buffer(width(), height());
     buffer.fill(Qt::transparent);
@@ -331,6 +358,8 @@ void QtCurveButton::drawButton(QPainter *painter)
     }
 
     bP.end();
+    if(cache)
+        Handler()->cacheButton(key, buffer);
     painter->drawPixmap(0, 0, buffer);
 }
 
@@ -373,7 +402,7 @@ QBitmap IconEngine::icon(ButtonIcon icon, int size, QStyle *style)
             break;
         }
         case MaxIcon:
-            if(Handler()->wStyle()->pixelMetric((QStyle::PixelMetric)QtC_TitleBarButtons, 0L, 0L)&TITLEBAR_BUTTOM_ARROW_MIN_MAX)
+            if(Handler()->styleMetrics().titleBarButtons&TITLEBAR_BUTTOM_ARROW_MIN_MAX)
             {
                 QStyleOption opt;
 
@@ -396,7 +425,7 @@ QBitmap IconEngine::icon(ButtonIcon icon, int size, QStyle *style)
             }
             break;
         case MaxRestoreIcon:
-            if(Handler()->wStyle()->pixelMetric((QStyle::PixelMetric)QtC_TitleBarButtons, 0L, 0L)&TITLEBAR_BUTTOM_ARROW_MIN_MAX)
+            if(Handler()->styleMetrics().titleBarButtons&TITLEBAR_BUTTOM_ARROW_MIN_MAX)
             {
                 p.drawLine(r.x()+1, r.y(), r.x()+r.width()-2, r.y());
                 p.drawLine(r.x()+1, r.y()+r.height()-1, r.x()+r.width()-2, r.y()+r.height()-1);
@@ -432,7 +461,7 @@ QBitmap IconEngine::icon(ButtonIcon icon, int size, QStyle *style)
             }
             break;
         case MinIcon:
-            if(Handler()->wStyle()->pixelMetric((QStyle::PixelMetric)QtC_TitleBarButtons, 0L, 0L)&TITLEBAR_BUTTOM_ARROW_MIN_MAX)
+            if(Handler()->styleMetrics().titleBarButtons&TITLEBAR_BUTTOM_ARROW_MIN_MAX)
             {
                 QStyleOption opt;
 
@@ -77,6 +77,8 @@ static const int constTitlePad=4;
 
 static const int constInvalidTab=-1;
 static const int constAddToEmpty=-2;
+// Max number of captions (window title, plus any tab titles) to keep elided per client
+static const int constMaxCaptions=16;
 
 static inline int tabCloseIconSize(int titleHeight)
 {
@@ -111,44 +113,47 @@ int getProperty(WId wId, const Atom &atom)
     return rv;
 }
 
-int getMenubarSizeProperty(WId wId)
+// The window properties that QtCurve apps set on their windows. These are read on first use, and the values kept
+// until the app says (via D-Bus) that they have changed - see QtCurveClient::propertiesChanged()
+static Atom propertyAtom(QtCurveClient::CachedProperty prop)
 {
-    static const Atom constAtom = XInternAtom(QX11Info::display(), MENU_SIZE_ATOM, False);
-    return getProperty(wId, constAtom);
-}
+    static Atom atoms[QtCurveClient::NUM_CACHED_PROPERTIES];
+    static bool haveAtoms=false;
 
-int getStatusbarSizeProperty(WId wId)
-{
-    static const Atom constAtom = XInternAtom(QX11Info::display(), STATUSBAR_ATOM, False);
-    return getProperty(wId, constAtom);
-}
-
-int getOpacityProperty(WId wId)
-{
-    static const Atom constAtom = XInternAtom(QX11Info::display(), OPACITY_ATOM, False);
-    int o=getProperty(wId, constAtom);
-    return o<0 || o>100 ? 100 : o;
+    if(!haveAtoms)
+    {
+        atoms[QtCurveClient::PROP_MENU_SIZE]=XInternAtom(QX11Info::display(), MENU_SIZE_ATOM, False);
+        atoms[QtCurveClient::PROP_STATUSBAR]=XInternAtom(QX11Info::display(), STATUSBAR_ATOM, False);
+        atoms[QtCurveClient::PROP_OPACITY]=XInternAtom(QX11Info::display(), OPACITY_ATOM, False);
+        atoms[QtCurveClient::PROP_BGND]=XInternAtom(QX11Info::display(), BGND_ATOM, False);
+        haveAtoms=true;
+    }
+    return atoms[prop];
 }
 
-void getBgndSettings(WId wId, EAppearance &app, QColor &col)
+static bool getBgndProperty(WId wId, unsigned long &val)
 {
-    static const Atom constAtom = XInternAtom(QX11Info::display(), BGND_ATOM, False);
-
     unsigned char *data;
     int           dummy;
     unsigned long num,
                   dummy2;
+    bool          rv(false);
 
-    if (Success==XGetWindowProperty(QX11Info::display(), wId, constAtom, 0L, 1, False, XA_CARDINAL, &dummy2, &dummy, &num, &dummy2, &data) && num>0)
+    if (Success==XGetWindowProperty(QX11Info::display(), wId, propertyAtom(QtCurveClient::PROP_BGND), 0L, 1, False, XA_CARDINAL, &dummy2, &dummy, &num, &dummy2, &data) && num>0)
     {
-        unsigned long val=*((unsigned long*)data);
-        app=(EAppearance)(val&0xFF);
-        col.setRgb((val&0xFF000000)>>24, (val&0x00FF0000)>>16, (val&0x0000FF00)>>8);
-
+        val=*((unsigned long*)data);
+        rv=true;
         XFree(data);
     }
     //else
     //    *data = NULL; // superflous?!?
+    return rv;
+}
+
+static void getBgndSettings(unsigned long val, EAppearance &app, QColor &col)
+{
+    app=(EAppearance)(val&0xFF);
+    col.setRgb((val&0xFF000000)>>24, (val&0x00FF0000)>>16, (val&0x0000FF00)>>8);
 }
 
 static QPainterPath createPath(const QRectF &r, double radiusTop, double radiusBot)
@@ -273,9 +278,13 @@ QtCurveClient::QtCurveClient(KDecorationBridge *bridge, QtCurveHandler *factory)
 #endif
              , itsResizeGrip(0L)
              , itsTitleFont(QFont())
+             , itsNextMask(0)
              , itsMenuBarSize(-1)
              , itsToggleMenuBarButton(0L)
              , itsToggleStatusBarButton(0L)
+             , itsValidProperties(0)
+             , itsHaveBgndProperty(false)
+             , itsBgndProperty(0)
 //              , itsHover(false)
 #if KDE_IS_VERSION(4, 3, 85) && !KDE_IS_VERSION(4, 8, 80)
              , itsClickInProgress(false)
@@ -507,14 +516,18 @@ void QtCurveClient::activeChange()
         itsResizeGrip->update();
     }
 
+    // Apps using an older QtCurve do not say when their background or opacity changes, so re-read these on
+    // (de)activation - which repaints anyway...
+    itsValidProperties&=~((1<<PROP_BGND)|(1<<PROP_OPACITY));
     informAppOfActiveChange();
     KCommonDecoration::activeChange();
 }
 
 void QtCurveClient::captionChange()
 {
+    itsCaptions.remove(itsCaption);
     itsCaption=caption();
-    widget()->update();
+    updateCaption();
 }
 
 void QtCurveClient::paintEvent(QPaintEvent *e)
@@ -523,12 +536,12 @@ void QtCurveClient::paintEvent(QPaintEvent *e)
     QPainter             painter(widget());
     QRect                r(widget()->rect());
     QStyleOptionTitleBar opt;
-    int                  windowBorder(Handler()->wStyle()->pixelMetric((QStyle::PixelMetric)QtC_WindowBorder, 0L, 0L));
+    int                  windowBorder(Handler()->styleMetrics().windowBorder);
     bool                 active(isActive()),
                          colorTitleOnly(windowBorder&WINDOW_BORDER_COLOR_TITLEBAR_ONLY),
                          roundBottom(Handler()->roundBottom()),
                          preview(isPreview()),
-                         blend(!preview && Handler()->wStyle()->pixelMetric((QStyle::PixelMetric)QtC_BlendMenuAndTitleBar, NULL, NULL)),
+                         blend(!preview && Handler()->styleMetrics().blendMenuAndTitleBar),
                          menuColor(windowBorder&WINDOW_BORDER_USE_MENUBAR_COLOR_FOR_TITLEBAR),
                          separator(active && windowBorder&WINDOW_BORDER_SEPARATOR),
                          maximized(isMaximized());
@@ -541,15 +554,17 @@ void QtCurveClient::paintEvent(QPaintEvent *e)
                          titleEdgeLeft(layoutMetric(LM_TitleEdgeLeft)),
                          titleEdgeRight(layoutMetric(LM_TitleEdgeRight)),
                          titleBarHeight(titleHeight+titleEdgeTop+titleEdgeBottom+(isMaximized() ? border : 0)),
-                         round=Handler()->wStyle()->pixelMetric((QStyle::PixelMetric)QtC_Round, NULL, NULL),
-                         buttonFlags=Handler()->wStyle()->pixelMetric((QStyle::PixelMetric)QtC_TitleBarButtons, NULL, NULL);
+                         round=Handler()->styleMetrics().round,
+                         buttonFlags=Handler()->styleMetrics().titleBarButtons;
     int                  rectX, rectY, rectX2, rectY2, shadowSize(0),
                          kwinOpacity(compositing ? Handler()->opacity(active) : 100),
                          opacity(kwinOpacity);
     EAppearance          bgndAppearance=APPEARANCE_FLAT;
     QColor               windowCol(widget()->palette().color(QPalette::Window));
+    unsigned long        bgndProperty;
 
-    getBgndSettings(windowId(), bgndAppearance, windowCol);
+    if(cachedBgndProperty(bgndProperty))
+        getBgndSettings(bgndProperty, bgndAppearance, windowCol);
 
     QColor               col(KDecoration::options()->color(KDecoration::ColorTitleBar, active)),
                          fillCol(colorTitleOnly ? windowCol : col);
@@ -567,7 +582,11 @@ void QtCurveClient::paintEvent(QPaintEvent *e)
     painter.setClipRegion(e->region());
 
     if(!preview && compositing && 100==opacity)
-        opacity=getOpacityProperty(windowId());
+    {
+        int o=cachedProperty(PROP_OPACITY);
+
+        opacity=o<0 || o>100 ? 100 : o;
+    }
 
 #if KDE_IS_VERSION(4, 3, 0)
     if(customShadows)
@@ -576,19 +595,24 @@ void QtCurveClient::paintEvent(QPaintEvent *e)
 
         if(compositing)
         {
-            TileSet *tileSet=Handler()->shadowCache().tileSet(this, roundBottom);
-            if(opacity<100)
+            // No need to draw the shadow if only the inside of the window (e.g. the caption) is being repainted - as this
+            // is either painted over, or clipped out.
+            if(!e->region().subtracted(getMask(round, r.adjusted(shadowSize, shadowSize, -shadowSize, -shadowSize))).isEmpty())
             {
-                painter.save();
-                painter.setClipRegion(QRegion(r).subtract(getMask(round, r.adjusted(shadowSize, shadowSize, -shadowSize, -shadowSize))), Qt::IntersectClip);
-            }
+                TileSet *tileSet=Handler()->shadowCache().tileSet(this, roundBottom);
+                if(opacity<100)
+                {
+                    painter.save();
+                    painter.setClipRegion(QRegion(r).subtract(getMask(round, r.adjusted(shadowSize, shadowSize, -shadowSize, -shadowSize))), Qt::IntersectClip);
+                }
 
-            if(!isMaximized())
-                tileSet->render(r.adjusted(5, 5, -5, -5), &painter, TileSet::Ring);
-            else if(isShade())
-                tileSet->render(r.adjusted(0, 5, 0, -5), &painter, TileSet::Bottom);
-            if(opacity<100)
-                painter.restore();
+                if(!isMaximized())
+                    tileSet->render(r.adjusted(5, 5, -5, -5), &painter, TileSet::Ring);
+                else if(isShade())
+                    tileSet->render(r.adjusted(0, 5, 0, -5), &painter, TileSet::Bottom);
+                if(opacity<100)
+                    painter.restore();
+            }
         }
         r.adjust(shadowSize, shadowSize, -shadowSize, -shadowSize);
     }
@@ -625,15 +649,15 @@ void QtCurveClient::paintEvent(QPaintEvent *e)
             itsMenuBarSize=QFontMetrics(QApplication::font()).height()+7;
         else
         {
-            int val=getMenubarSizeProperty(windowId());
+            int val=cachedProperty(PROP_MENU_SIZE);
             if(val>-1)
                 itsMenuBarSize=val;
         }
     }
 
     if(menuColor && itsMenuBarSize>0 &&
-       (active || !Handler()->wStyle()->pixelMetric((QStyle::PixelMetric)QtC_ShadeMenubarOnlyWhenActive, NULL, NULL)))
-        col=QColor(QRgb(Handler()->wStyle()->pixelMetric((QStyle::PixelMetric)QtC_MenubarColor, NULL, NULL)));
+       (active || !Handler()->styleMetrics().shadeMenubarOnlyWhenActive))
+        col=QColor(Handler()->menubarColor());
 
     if(opacity<100)
     {
@@ -668,8 +692,7 @@ void QtCurveClient::paintEvent(QPaintEvent *e)
     QPainterPath fillPath(maximized || round<=ROUND_SLIGHT
                                 ? QPainterPath()
                                 : createPath(QRectF(fillRect),
-                                             APPEARANCE_NONE==Handler()->wStyle()->pixelMetric((QStyle::PixelMetric)QtC_TitleBarApp,
-                                                                                               &opt, NULL) ? 6.0 : 8.0,
+                                             APPEARANCE_NONE==Handler()->styleMetrics().titleBarApp[active ? 1 : 0] ? 6.0 : 8.0,
                                              roundBottom ? 6.0 : 1.0));
 
 
@@ -836,7 +859,7 @@ void QtCurveClient::paintEvent(QPaintEvent *e)
              vOffset=hOffset+(outerBorder ? 1 :0),
              posAdjust=maximized || outerBorder ? 2 : 0,
              edgePad=Handler()->edgePad();
-        bool menuIcon=TITLEBAR_ICON_MENU_BUTTON==Handler()->wStyle()->pixelMetric((QStyle::PixelMetric)QtC_TitleBarIcon, 0L, 0L),
+        bool menuIcon=TITLEBAR_ICON_MENU_BUTTON==Handler()->styleMetrics().titleBarIcon,
              menuOnlyLeft=menuIcon && onlyMenuIcon(true),
              menuOnlyRight=menuIcon && !menuOnlyLeft && onlyMenuIcon(false);
 
@@ -849,7 +872,7 @@ void QtCurveClient::paintEvent(QPaintEvent *e)
                                             buttonsRightWidth(), titleBarHeight-2*(vOffset+edgePad)), col, buttonFlags&TITLEBAR_BUTTON_ROUND, round);
     }
 
-    bool showIcon=TITLEBAR_ICON_NEXT_TO_TITLE==Handler()->wStyle()->pixelMetric((QStyle::PixelMetric)QtC_TitleBarIcon,  0L, 0L);
+    bool showIcon=TITLEBAR_ICON_NEXT_TO_TITLE==Handler()->styleMetrics().titleBarIcon;
     int  iconSize=showIcon ? Handler()->wStyle()->pixelMetric(QStyle::PM_SmallIconSize) : 0;
 
 #if KDE_IS_VERSION(4, 3, 85) && !KDE_IS_VERSION(4, 8, 80)
@@ -935,13 +958,13 @@ void QtCurveClient::paintEvent(QPaintEvent *e)
 #endif
 
     bool hideToggleButtons(true);
-    int  toggleButtons(Handler()->wStyle()->pixelMetric((QStyle::PixelMetric)QtC_ToggleButtons, NULL, NULL));
+    int  toggleButtons(Handler()->styleMetrics().toggleButtons);
 
     if(toggleButtons)
     {
-        if(!itsToggleMenuBarButton && toggleButtons&0x01 && (Handler()->wasLastMenu(windowId()) || getMenubarSizeProperty(windowId())>-1))
+        if(!itsToggleMenuBarButton && toggleButtons&0x01 && (Handler()->wasLastMenu(windowId()) || cachedProperty(PROP_MENU_SIZE)>-1))
             itsToggleMenuBarButton=createToggleButton(true);
-        if(!itsToggleStatusBarButton && toggleButtons&0x02 && (Handler()->wasLastStatus(windowId()) || getStatusbarSizeProperty(windowId())>-1))
+        if(!itsToggleStatusBarButton && toggleButtons&0x02 && (Handler()->wasLastStatus(windowId()) || cachedProperty(PROP_STATUSBAR)>-1))
             itsToggleStatusBarButton=createToggleButton(false);
 
     //     if(itsHover)
@@ -956,7 +979,7 @@ void QtCurveClient::paintEvent(QPaintEvent *e)
                     (itsToggleMenuBarButton ? itsToggleMenuBarButton->width() : 0) +
                     (itsToggleStatusBarButton ? itsToggleStatusBarButton->width() : 0)) < r.width())
                 {
-                    int  align(Handler()->wStyle()->pixelMetric((QStyle::PixelMetric)QtC_TitleAlignment, 0L, 0L));
+                    int  align(Handler()->styleMetrics().titleAlignment);
                     bool onLeft(align&Qt::AlignRight);
 
                     if(align&Qt::AlignHCenter)
@@ -1005,7 +1028,7 @@ void QtCurveClient::paintEvent(QPaintEvent *e)
     if(separator)
     {
         QColor        color(KDecoration::options()->color(KDecoration::ColorFont, isActive()));
-        Qt::Alignment align((Qt::Alignment)Handler()->wStyle()->pixelMetric((QStyle::PixelMetric)QtC_TitleAlignment, 0L, 0L));
+        Qt::Alignment align((Qt::Alignment)Handler()->styleMetrics().titleAlignment);
 
         r.adjust(16, titleBarHeight-1, -16, 0);
         color.setAlphaF(0.5);
@@ -1025,18 +1048,31 @@ void QtCurveClient::paintTitle(QPainter *painter, const QRect &capRect, const QR
     {
         painter->setFont(itsTitleFont);
 
-        QFontMetrics  fm(painter->fontMetrics());
-        QString       str(fm.elidedText(cap, Qt::ElideRight,
-                            capRect.width()-(showIcon ? pix.width()+constTitlePad : 0), QPalette::WindowText));
-        Qt::Alignment hAlign((Qt::Alignment)Handler()->wStyle()->pixelMetric((QStyle::PixelMetric)QtC_TitleAlignment, 0L, 0L)),
+        if(!itsCaptions.contains(cap) && itsCaptions.count()>=constMaxCaptions)
+            itsCaptions.clear();
+
+        Caption       &cached(itsCaptions[cap]);
+        int           availWidth(capRect.width()-(showIcon ? pix.width()+constTitlePad : 0));
+
+        if(cached.width!=availWidth)
+        {
+            QFontMetrics fm(painter->fontMetrics());
+
+            cached.width=availWidth;
+            cached.str=fm.elidedText(cap, Qt::ElideRight, availWidth, QPalette::WindowText);
+            cached.strWidth=fm.boundingRect(cached.str).width();
+        }
+
+        const QString &str(cached.str);
+        Qt::Alignment hAlign((Qt::Alignment)Handler()->styleMetrics().titleAlignment),
                       alignment(Qt::AlignVCenter|hAlign);
         bool          alignFull(!isTab && Qt::AlignHCenter==hAlign),
                       reverse=Qt::RightToLeft==QApplication::layoutDirection(),
                       iconRight((!reverse && alignment&Qt::AlignRight) || (reverse && alignment&Qt::AlignLeft));
         QRect         textRect(alignFull ? alignFullRect : capRect);
         int           textWidth=alignFull || (showIcon && alignment&Qt::AlignHCenter)
-                                    ? fm.boundingRect(str).width()+(showIcon ? pix.width()+constTitlePad : 0) : 0;
-        EEffect       effect((EEffect)(Handler()->wStyle()->pixelMetric((QStyle::PixelMetric)QtC_TitleBarEffect)));
+                                    ? cached.strWidth+(showIcon ? pix.width()+constTitlePad : 0) : 0;
+        EEffect       effect((EEffect)(Handler()->styleMetrics().titleBarEffect));
 
         if(alignFull)
         {
@@ -1166,15 +1202,71 @@ void QtCurveClient::updateWindowShape()
 #endif
                       widget()->rect());
 
-        setMask(getMask(Handler()->wStyle()->pixelMetric((QStyle::PixelMetric)QtC_Round, NULL, NULL), r));
+        setMask(getMask(Handler()->styleMetrics().round, r));
     }
 }
 
 QRegion QtCurveClient::getMask(int round, const QRect &r) const
 {
-    int x, y, w, h;
+    bool roundBottom(!isShade() && Handler()->roundBottom());
+
+    for(int i=0; i<constNumMasks; ++i)
+        if(itsMasks[i].round==round && itsMasks[i].roundBottom==roundBottom && itsMasks[i].size==r.size())
+            return itsMasks[i].region.translated(r.topLeft());
+
+    WindowMask &mask(itsMasks[itsNextMask]);
+
+    mask.size=r.size();
+    mask.round=round;
+    mask.roundBottom=roundBottom;
+    mask.region=createMask(round, roundBottom, r.width(), r.height());
+    itsNextMask=(itsNextMask+1)%constNumMasks;
+    return mask.region.translated(r.topLeft());
+}
+
+// The masks are a set of horizontal bands - so, if the window is large enough for the corners not to overlap, these are
+// passed to QRegion in one go. This avoids building the region up rect-by-rect on each resize step.
+static QRegion createBandedMask(int round, bool roundBottom, int w, int h)
+{
+    QRect rects[9];
+    int   num=0;
+
+    if(ROUND_SLIGHT==round)
+    {
+        rects[num++]=QRect(1, 0, w-2, 1);
+        rects[num++]=QRect(0, 1, w, h-2);
+        rects[num++]=QRect(1, h-1, w-2, 1);
+    }
+    else
+    {
+        rects[num++]=QRect(5, 0, w-10, 1);
+        rects[num++]=QRect(3, 1, w-6, 1);
+        rects[num++]=QRect(2, 2, w-4, 1);
+        rects[num++]=QRect(1, 3, w-2, 2);
+        if(roundBottom)
+        {
+            rects[num++]=QRect(0, 5, w, h-10);
+            rects[num++]=QRect(1, h-5, w-2, 2);
+            rects[num++]=QRect(2, h-3, w-4, 1);
+            rects[num++]=QRect(3, h-2, w-6, 1);
+            rects[num++]=QRect(5, h-1, w-10, 1);
+        }
+        else
+            rects[num++]=QRect(0, 5, w, h-5);
+    }
+
+    QRegion mask;
+
+    mask.setRects(rects, num);
+    return mask;
+}
+
+QRegion QtCurveClient::createMask(int round, bool roundBottom, int w, int h)
+{
+    int x=0, y=0;
 
-    r.getRect(&x, &y, &w, &h);
+    if(ROUND_NONE!=round && w>10 && h>10)
+        return createBandedMask(round, roundBottom, w, h);
 
     switch(round)
     {
@@ -1190,8 +1282,6 @@ QRegion QtCurveClient::getMask(int round, const QRect &r) const
         }
         default: // ROUND_FULL
         {
-            bool    roundBottom=!isShade() && Handler()->roundBottom();
-
 // #if KDE_IS_VERSION(4, 3, 0)
 //             if(!isPreview() && COMPOSITING_ENABLED)
 //             {
@@ -1287,14 +1377,26 @@ QRect QtCurveClient::captionRect() const
     return QRect(titleLeft, r.top()+titleEdgeTop, titleWidth, titleHeight);
 }
 
+// Only repaint the caption, so that apps that change their title rapidly (browsers, terminals, etc.) do not cause the
+// whole decoration - and its shadow - to be repainted.
 void QtCurveClient::updateCaption()
 {
+#if KDE_IS_VERSION(4, 3, 85) && !KDE_IS_VERSION(4, 8, 80)
+    // Tabs are laid out across the whole titlebar...
+    if(clientGroupItems().count()>1)
+    {
+        widget()->update();
+        return;
+    }
+#endif
+
     QRect oldCaptionRect(itsCaptionRect);
 
     itsCaptionRect=QtCurveClient::captionRect();
 
+    // The text's shadow/etch is drawn 1 pixel below, and possibly to the right of, the caption rect.
     if (oldCaptionRect.isValid() && itsCaptionRect.isValid())
-        widget()->update(oldCaptionRect|itsCaptionRect);
+        widget()->update((oldCaptionRect|itsCaptionRect).adjusted(0, 0, 1, 1));
     else
         widget()->update();
 }
@@ -1429,7 +1531,7 @@ bool QtCurveClient::mouseMoveEvent(QMouseEvent *e)
         pix.fill(Qt::transparent);
         QPainter painter(&pix);
 
-        bool  showIcon=TITLEBAR_ICON_NEXT_TO_TITLE==Handler()->wStyle()->pixelMetric((QStyle::PixelMetric)QtC_TitleBarIcon,  0L, 0L);
+        bool  showIcon=TITLEBAR_ICON_NEXT_TO_TITLE==Handler()->styleMetrics().titleBarIcon;
         int   iconSize=showIcon ? Handler()->wStyle()->pixelMetric(QStyle::PM_SmallIconSize) : 0;
         QRect r(0, 0, geom.size().width()-(tabList.count() ? (TAB_CLOSE_ICON_SIZE+constTitlePad) : 0), geom.size().height());
 
@@ -1593,6 +1695,8 @@ void QtCurveClient::reset(unsigned long changed)
         // Reset button backgrounds...
         for(int i=0; i<constNumButtonStates; ++i)
            itsButtonBackground[i].pix=QPixmap();
+        itsCaptions.clear();
+        itsValidProperties=0;
     }
 
     if (changed&SettingBorder)
@@ -1664,7 +1768,7 @@ void QtCurveClient::informAppOfBorderSizeChanges()
 
 void QtCurveClient::informAppOfActiveChange()
 {
-    if(Handler()->wStyle()->pixelMetric((QStyle::PixelMetric)QtC_ShadeMenubarOnlyWhenActive, NULL, NULL))
+    if(Handler()->styleMetrics().shadeMenubarOnlyWhenActive)
     {
         static const Atom constQtCActiveWindow = XInternAtom(QX11Info::display(), ACTIVE_WINDOW_ATOM, False);
 
@@ -1729,7 +1833,8 @@ const QString & QtCurveClient::windowClass()
 void QtCurveClient::menuBarSize(int size)
 {
     itsMenuBarSize=size;
-    if(Handler()->wStyle()->pixelMetric((QStyle::PixelMetric)QtC_ToggleButtons, NULL, NULL) &0x01)
+    itsValidProperties&=~(1<<PROP_MENU_SIZE);
+    if(Handler()->styleMetrics().toggleButtons &0x01)
     {
         if(!itsToggleMenuBarButton)
             itsToggleMenuBarButton=createToggleButton(true);
@@ -1742,7 +1847,8 @@ void QtCurveClient::menuBarSize(int size)
 void QtCurveClient::statusBarState(bool state)
 {
     Q_UNUSED(state)
-    if(Handler()->wStyle()->pixelMetric((QStyle::PixelMetric)QtC_ToggleButtons, NULL, NULL) &0x02)
+    itsValidProperties&=~(1<<PROP_STATUSBAR);
+    if(Handler()->styleMetrics().toggleButtons &0x02)
     {
         if(!itsToggleStatusBarButton)
             itsToggleStatusBarButton=createToggleButton(false);
@@ -1752,6 +1858,35 @@ void QtCurveClient::statusBarState(bool state)
     KCommonDecoration::activeChange();
 }
 
+void QtCurveClient::propertiesChanged()
+{
+    itsValidProperties=0;
+    // The background and opacity are only read when painting, so repaint to pick up the new values...
+    widget()->update();
+}
+
+int QtCurveClient::cachedProperty(CachedProperty prop)
+{
+    if(!(itsValidProperties&(1<<prop)))
+    {
+        itsProperties[prop]=getProperty(windowId(), propertyAtom(prop));
+        itsValidProperties|=1<<prop;
+    }
+    return itsProperties[prop];
+}
+
+bool QtCurveClient::cachedBgndProperty(unsigned long &val)
+{
+    if(!(itsValidProperties&(1<<PROP_BGND)))
+    {
+        itsHaveBgndProperty=getBgndProperty(windowId(), itsBgndProperty);
+        itsValidProperties|=1<<PROP_BGND;
+    }
+
+    val=itsBgndProperty;
+    return itsHaveBgndProperty;
+}
+
 void QtCurveClient::toggleMenuBar()
 {
     sendToggleToApp(true);
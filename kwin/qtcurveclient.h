@@ -37,6 +37,7 @@
 #ifdef QTC_KWIN_MAX_BUTTON_HACK
 #undef private
 #endif
+#include <QtCore/QHash>
 #include <QtGui/QPixmap>
 #include <QtGui/QColor>
 #include "qtcurvehandler.h"
@@ -59,6 +60,15 @@ class QtCurveClient :
 
     public:
 
+    enum CachedProperty
+    {
+        PROP_MENU_SIZE,
+        PROP_STATUSBAR,
+        PROP_OPACITY,
+        PROP_BGND,
+        NUM_CACHED_PROPERTIES
+    };
+
     QtCurveClient(KDecorationBridge *bridge, QtCurveHandler *factory);
     virtual ~QtCurveClient();
 
@@ -87,6 +97,7 @@ class QtCurveClient :
     QtCurveToggleButton *     createToggleButton(bool menubar);
     void                      informAppOfBorderSizeChanges();
     void                      sendToggleToApp(bool menubar);
+    void                      propertiesChanged();
 
     public Q_SLOTS:
 
@@ -112,6 +123,9 @@ class QtCurveClient :
     void                      deleteSizeGrip();
     void                      informAppOfActiveChange();
     const QString &           windowClass();
+    int                       cachedProperty(CachedProperty prop);
+    bool                      cachedBgndProperty(unsigned long &val);
+    static QRegion            createMask(int round, bool roundBottom, int w, int h);
 
     private:
 
@@ -122,17 +136,50 @@ class QtCurveClient :
         QColor  col;
     };
 
+    // A caption, elided to fit the width available, and the width of the elided string. The text itself is still
+    // drawn directly onto the titlebar, so that it keeps sub-pixel anti-aliasing, and is not clipped to a pixmap.
+    struct Caption
+    {
+        Caption() : width(-1), strWidth(0) { }
+
+        int     width,
+                strWidth;
+        QString str;
+    };
+
     static const int constNumButtonStates=2;
 
+    // Window masks are created at 0,0 - and translated into place when used. The widget shape, and the paint clip,
+    // usually use the same size - so only the last couple of masks are kept.
+    struct WindowMask
+    {
+        WindowMask() : round(-1), roundBottom(false) { }
+
+        QSize   size;
+        int     round;
+        bool    roundBottom;
+        QRegion region;
+    };
+
+    static const int constNumMasks=2;
+
     QtCurveSizeGrip        *itsResizeGrip;
     ButtonBgnd             itsButtonBackground[constNumButtonStates];
     QRect                  itsCaptionRect;
     QString                itsCaption,
                            itsWindowClass;
     QFont                  itsTitleFont;
+    QHash<QString, Caption> itsCaptions;       // Keyed on the caption - cleared when the font or colours change
+    mutable WindowMask     itsMasks[constNumMasks];
+    mutable int            itsNextMask;
     int                    itsMenuBarSize;
     QtCurveToggleButton    *itsToggleMenuBarButton,
                            *itsToggleStatusBarButton;
+    // Window properties set by QtCurve apps, kept until they change - see propertiesChanged()
+    unsigned int           itsValidProperties;
+    int                    itsProperties[NUM_CACHED_PROPERTIES];
+    bool                   itsHaveBgndProperty;
+    unsigned long          itsBgndProperty;
 //     bool                   itsHover;
 #if KDE_IS_VERSION(4, 3, 85) && !KDE_IS_VERSION(4, 8, 80)
     QList<QtCurveButton *> itsCloseButtons;
@@ -50,6 +50,7 @@ class QtCurveDBus : public QDBusAbstractAdaptor
 
     Q_NOREPLY void menuBarSize(unsigned int xid, int size)      { Handler()->menuBarSize(xid, size); }
     Q_NOREPLY void statusBarState(unsigned int xid, bool state) { Handler()->statusBarState(xid, state); }
+    Q_NOREPLY void windowPropertiesChanged(unsigned int xid)    { Handler()->windowPropertiesChanged(xid); }
 };
 
 }
@@ -93,10 +93,14 @@ QtCurveHandler * Handler()
     return handler;
 }
 
+// Enough for all of the button states of a few window sizes.
+static const int constButtonCacheSize=256*1024;
+
 QtCurveHandler::QtCurveHandler()
               : itsLastMenuXid(0)
               , itsLastStatusXid(0)
               , itsStyle(NULL)
+              , itsButtonCache(constButtonCacheSize)
               , itsDBus(NULL)
 {
     handler=this;
@@ -156,6 +160,8 @@ bool QtCurveHandler::reset(unsigned long changed)
         styleChanged=true;
     }
 
+    readStyleMetrics();
+
     // we assume the active font to be the same as the inactive font since the control
     // center doesn't offer different settings anyways.
     itsTitleFont = KDecoration::options()->font(true, false); // not small
@@ -176,6 +182,7 @@ bool QtCurveHandler::reset(unsigned long changed)
     for (int t=0; t < 2; ++t)
         for (int i=0; i < NumButtonIcons; i++)
             itsBitmaps[t][i]=QPixmap();
+    itsButtonCache.clear();
 
     // Do we need to "hit the wooden hammer" ?
     bool needHardReset = true;
@@ -193,6 +200,32 @@ bool QtCurveHandler::reset(unsigned long changed)
     }
 }
 
+void QtCurveHandler::readStyleMetrics()
+{
+    QStyle       *style(wStyle());
+    QStyleOption opt;
+
+    itsStyleMetrics.round=style->pixelMetric((QStyle::PixelMetric)QtC_Round, 0L, 0L);
+    itsStyleMetrics.windowBorder=style->pixelMetric((QStyle::PixelMetric)QtC_WindowBorder, 0L, 0L);
+    itsStyleMetrics.titleAlignment=style->pixelMetric((QStyle::PixelMetric)QtC_TitleAlignment, 0L, 0L);
+    itsStyleMetrics.titleBarButtons=style->pixelMetric((QStyle::PixelMetric)QtC_TitleBarButtons, 0L, 0L);
+    itsStyleMetrics.titleBarIcon=style->pixelMetric((QStyle::PixelMetric)QtC_TitleBarIcon, 0L, 0L);
+    itsStyleMetrics.titleBarEffect=style->pixelMetric((QStyle::PixelMetric)QtC_TitleBarEffect, 0L, 0L);
+    itsStyleMetrics.toggleButtons=style->pixelMetric((QStyle::PixelMetric)QtC_ToggleButtons, 0L, 0L);
+    opt.state=QStyle::State_None;
+    itsStyleMetrics.titleBarApp[0]=style->pixelMetric((QStyle::PixelMetric)QtC_TitleBarApp, &opt, 0L);
+    opt.state=QStyle::State_Active;
+    itsStyleMetrics.titleBarApp[1]=style->pixelMetric((QStyle::PixelMetric)QtC_TitleBarApp, &opt, 0L);
+    itsStyleMetrics.customBgnd=style->pixelMetric((QStyle::PixelMetric)QtC_CustomBgnd, 0L, 0L);
+    itsStyleMetrics.blendMenuAndTitleBar=style->pixelMetric((QStyle::PixelMetric)QtC_BlendMenuAndTitleBar, 0L, 0L);
+    itsStyleMetrics.shadeMenubarOnlyWhenActive=style->pixelMetric((QStyle::PixelMetric)QtC_ShadeMenubarOnlyWhenActive, 0L, 0L);
+}
+
+QRgb QtCurveHandler::menubarColor() const
+{
+    return wStyle()->pixelMetric((QStyle::PixelMetric)QtC_MenubarColor, 0L, 0L);
+}
+
 void QtCurveHandler::setBorderSize()
 {
     switch(itsConfig.borderSize())
@@ -270,7 +303,7 @@ bool QtCurveHandler::supports(Ability ability) const
 #endif
 #if KDE_IS_VERSION(4, 5, 85)
         case AbilityUsesBlurBehind:
-            return opacity(true)<100 || opacity(false)<100 || wStyle()->pixelMetric((QStyle::PixelMetric)QtC_CustomBgnd, 0L, 0L);
+            return opacity(true)<100 || opacity(false)<100 || itsStyleMetrics.customBgnd;
 #endif
         default:
             return false;
@@ -313,7 +346,7 @@ bool QtCurveHandler::readConfig(bool compositingToggled)
     }
     else if(compositingToggled && !itsConfig.outerBorder() &&
            (itsConfig.borderSize()<QtCurveConfig::BORDER_TINY ||
-            (wStyle()->pixelMetric((QStyle::PixelMetric)QtC_WindowBorder, 0L, 0L)&WINDOW_BORDER_COLOR_TITLEBAR_ONLY)))
+            (itsStyleMetrics.windowBorder&WINDOW_BORDER_COLOR_TITLEBAR_ONLY)))
     {
         QDBusConnection::sessionBus().send(QDBusMessage::createSignal("/KWin", "org.kde.KWin", "reloadConfig"));
         borderHack=true;
@@ -375,6 +408,7 @@ bool QtCurveHandler::readConfig(bool compositingToggled)
 
         if(shadowChanged || oldConfig.roundBottom()!=roundBottom())
             itsShadowCache.reset();
+        itsShadowCache.prepare(QApplication::palette().color(QPalette::Window), roundBottom());
     }
 #endif
 
@@ -441,6 +475,19 @@ void QtCurveHandler::menuBarSize(unsigned int xid, int size)
     itsLastMenuXid=xid;
 }
 
+void QtCurveHandler::windowPropertiesChanged(unsigned int xid)
+{
+    QList<QtCurveClient *>::ConstIterator it(itsClients.begin()),
+                                          end(itsClients.end());
+
+    for(; it!=end; ++it)
+        if((*it)->windowId()==xid)
+        {
+            (*it)->propertiesChanged();
+            break;
+        }
+}
+
 void QtCurveHandler::statusBarState(unsigned int xid, bool state)
 {
     QList<QtCurveClient *>::ConstIterator it(itsClients.begin()),
@@ -470,8 +517,8 @@ int QtCurveHandler::borderEdgeSize() const
     return itsConfig.edgePad()+
                 (outerBorder()
                     ? (itsConfig.borderSize()>QtCurveConfig::BORDER_NO_SIDES &&
-                        wStyle()->pixelMetric((QStyle::PixelMetric)QtC_Round, 0L, 0L)<ROUND_FULL)
-                        ? wStyle()->pixelMetric((QStyle::PixelMetric)QtC_WindowBorder, 0L, 0L)&WINDOW_BORDER_ADD_LIGHT_BORDER
+                        itsStyleMetrics.round<ROUND_FULL)
+                        ? itsStyleMetrics.windowBorder&WINDOW_BORDER_ADD_LIGHT_BORDER
                             ? 2
                             : 1
                         : 3
@@ -30,6 +30,8 @@
 #include <QtGui/QFont>
 #include <QtGui/QApplication>
 #include <QtGui/QBitmap>
+#include <QtGui/QPixmap>
+#include <QtCore/QCache>
 #include <kdeversion.h>
 #include <kdecoration.h>
 #include <kdecorationfactory.h>
@@ -81,6 +83,24 @@ class QtCurveHandler : public QObject,
 
     public:
 
+    // The style's QtC_* metrics that the decoration uses. These only change when the style's settings do, so are read
+    // once in reset() - rather than asking the style for them on every paint. (The menubar colour also depends upon
+    // the style's palette, which may change after reset() - so that is not stored, see menubarColor())
+    struct StyleMetrics
+    {
+        int  round,
+             windowBorder,
+             titleAlignment,
+             titleBarButtons,
+             titleBarIcon,
+             titleBarEffect,
+             toggleButtons,
+             titleBarApp[2];     // 0=inactive, 1=active
+        bool customBgnd,
+             blendMenuAndTitleBar,
+             shadeMenubarOnlyWhenActive;
+    };
+
     QtCurveHandler();
     ~QtCurveHandler();
     void setStyle();
@@ -91,6 +111,10 @@ class QtCurveHandler : public QObject,
     virtual bool supports(Ability ability) const;
 
     const QBitmap &       buttonBitmap(ButtonIcon type, const QSize &size, bool toolWindow);
+    const QPixmap *       cachedButton(quint64 key) const { return itsButtonCache.object(key); }
+    void                  cacheButton(quint64 key, const QPixmap &pix)
+                              { itsButtonCache.insert(key, new QPixmap(pix), pix.width()*pix.height()); }
+    QRgb                  menubarColor() const;
     int                   titleHeight() const        { return itsTitleHeight; }
     int                   titleHeightTool() const    { return itsTitleHeightTool; }
     const QFont &         titleFont()                { return itsTitleFont; }
@@ -102,6 +126,7 @@ class QtCurveHandler : public QObject,
     QtCurveConfig::Shade  outerBorder() const        { return itsConfig.outerBorder(); }
     QtCurveConfig::Shade  innerBorder() const        { return itsConfig.innerBorder(); }
     QStyle *              wStyle() const             { return itsStyle ? itsStyle : QApplication::style(); }
+    const StyleMetrics &  styleMetrics() const       { return itsStyleMetrics; }
     int                   borderEdgeSize() const;
     int                   titleBarPad() const        { return itsConfig.titleBarPad(); }
     int                   edgePad() const            { return itsConfig.edgePad(); }
@@ -117,6 +142,7 @@ class QtCurveHandler : public QObject,
 #endif
     void                  menuBarSize(unsigned int xid, int size);
     void                  statusBarState(unsigned int xid, bool state);
+    void                  windowPropertiesChanged(unsigned int xid);
     void                  emitToggleMenuBar(int xid);
     void                  emitToggleStatusBar(int xid);
     void                  borderSizeChanged();
@@ -129,6 +155,7 @@ class QtCurveHandler : public QObject,
     private:
 
     bool readConfig(bool compositingToggled=false);
+    void readStyleMetrics();
 
     private:
 
@@ -142,7 +169,9 @@ class QtCurveHandler : public QObject,
     QFont                  itsTitleFont,
                            itsTitleFontTool;
     QStyle                 *itsStyle;
+    StyleMetrics           itsStyleMetrics;
     QBitmap                itsBitmaps[2][NumButtonIcons];
+    QCache<quint64, QPixmap> itsButtonCache;     // Fully rendered buttons, cost is in pixels
     QtCurveConfig          itsConfig;
     QList<QtCurveClient *> itsClients;
     QtCurveDBus            *itsDBus;
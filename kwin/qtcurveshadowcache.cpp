@@ -79,6 +79,7 @@ static QColor calcLightColor(const QColor &color)
 QtCurveShadowCache::QtCurveShadowCache()
                   : activeShadowConfiguration_(QtCurveShadowConfiguration(QPalette::Active))
                   , inactiveShadowConfiguration_(QtCurveShadowConfiguration(QPalette::Inactive))
+                  , preparedRoundAllCorners_(false)
 {
     shadowCache_.setMaxCost(1<<6);
 }
@@ -94,8 +95,10 @@ void QtCurveShadowCache::setShadowConfiguration(const QtCurveShadowConfiguration
 {
     QtCurveShadowConfiguration &local = (other.colorGroup() == QPalette::Active)
             ? activeShadowConfiguration_:inactiveShadowConfiguration_;
-    local = other;
+    if(local == other)
+        return;
 
+    local = other;
     reset();
 }
 
@@ -107,13 +110,49 @@ TileSet * QtCurveShadowCache::tileSet(const QtCurveClient *client, bool roundAll
     if(shadowCache_.contains(hash))
         return shadowCache_.object(hash);
 
-    qreal   size(shadowSize());
-    TileSet *tileSet = new TileSet(shadowPixmap(client, key.active, roundAllCorners), size, size, 1, 1);
+    TileSet *tileSet = createTileSet(shadowPixmap(client, key.active, roundAllCorners));
 
     shadowCache_.insert(hash, tileSet);
     return tileSet;
 }
 
+void QtCurveShadowCache::prepare(const QColor &color, bool roundAllCorners)
+{
+    if(color != preparedColor_ || roundAllCorners != preparedRoundAllCorners_)
+    {
+        reset();
+        preparedColor_ = color;
+        preparedRoundAllCorners_ = roundAllCorners;
+    }
+
+    for(int active = 0; active < 2; ++active)
+    {
+        Key normal,
+            shaded;
+
+        normal.active = shaded.active = active;
+        shaded.isShade = true;
+
+        if(shadowCache_.contains(normal.hash()) && shadowCache_.contains(shaded.hash()))
+            continue;
+
+        // The shadow pixmap does not depend upon the shade state - so render this once, and slice it for both keys.
+        QPixmap pix(simpleShadowPixmap(color, active, roundAllCorners));
+
+        if(!shadowCache_.contains(normal.hash()))
+            shadowCache_.insert(normal.hash(), createTileSet(pix));
+        if(!shadowCache_.contains(shaded.hash()))
+            shadowCache_.insert(shaded.hash(), createTileSet(pix));
+    }
+}
+
+TileSet * QtCurveShadowCache::createTileSet(const QPixmap &pix) const
+{
+    qreal size(shadowSize());
+
+    return new TileSet(pix, size, size, 1, 1);
+}
+
 QPixmap QtCurveShadowCache::shadowPixmap(const QtCurveClient *client, bool active, bool roundAllCorners) const
 {
     Key      key(client);
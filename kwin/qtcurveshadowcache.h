@@ -90,6 +90,13 @@ class QtCurveShadowCache
 
     TileSet * tileSet(const QtCurveClient *client, bool roundAllCorners);
 
+    //! create the tilesets for all client states up front
+    /*!
+    called whenever the configuration is (re)loaded, so that mapping the first window
+    does not have to render the shadows
+    */
+    void prepare(const QColor &color, bool roundAllCorners);
+
     //! Key class to be used into QCache
     /*! class is entirely inline for optimization */
     class Key
@@ -159,11 +166,15 @@ class QtCurveShadowCache
     /*! a separate method is used in order to properly account for corners */
     void renderGradient(QPainter &p, const QRectF &rect, const QRadialGradient &rg, bool hasBorder) const;
 
+    TileSet * createTileSet(const QPixmap &pix) const;
+
     typedef QCache<int, TileSet> TileSetCache;
 
     QtCurveShadowConfiguration activeShadowConfiguration_,
                                inactiveShadowConfiguration_;
     TileSetCache               shadowCache_;
+    QColor                     preparedColor_;
+    bool                       preparedRoundAllCorners_;
 };
 }
 
@@ -122,8 +122,8 @@ void QtCurveToggleButton::drawButton(QPainter *painter)
 
     QRectF       ellipse(r.x()+0.5, r.y()+0.5, r.width(), r.height());
     QColor       bgnd(KDecoration::options()->color(KDecoration::ColorTitleBar, active));
-    bool         round=Handler()->wStyle()->pixelMetric((QStyle::PixelMetric)QtC_TitleBarButtons, 0L, 0L)&TITLEBAR_BUTTON_ROUND;
-    double       squareRad=round || Handler()->wStyle()->pixelMetric((QStyle::PixelMetric)QtC_Round, 0L, 0L)<ROUND_FULL ? 0.0 : 2.0;
+    bool         round=Handler()->styleMetrics().titleBarButtons&TITLEBAR_BUTTON_ROUND;
+    double       squareRad=round || Handler()->styleMetrics().round<ROUND_FULL ? 0.0 : 2.0;
     QPainterPath path;
 
     bgnd.setAlphaF(itsHover ? 0.9 : 0.4);
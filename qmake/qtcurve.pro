@@ -15,22 +15,32 @@ HEADERS += \
            ../common/colorutils.h \
            ../common/common.h \
            ../common/config_file.h \
+           ../style/bgndimageloader.h \
            ../style/blurhelper.h \
            ../style/dialogpixmaps.h \
+           ../style/disktilecache.h \
            ../style/fixx11h.h \
+           ../style/pixmapcache.h \
            ../style/pixmaps.h \
+           ../style/qtckey.h \
            ../style/qtcurve.h \
+           ../style/shadecache.h \
            ../style/shortcuthandler.h \
+           ../style/tileset.h \
            ../style/utils.h \
+           ../style/widgetclass.h \
            ../style/windowmanager.h \
 
 SOURCES += \
            ../common/colorutils.c \
            ../common/common.c \
            ../common/config_file.c \
+           ../style/bgndimageloader.cpp \
            ../style/blurhelper.cpp \
+           ../style/disktilecache.cpp \
            ../style/qtcurve.cpp \
            ../style/shortcuthandler.cpp \
+           ../style/tileset.cpp \
            ../style/utils.cpp \
            ../style/windowmanager.cpp \
 
@@ -0,0 +1,807 @@
+/*
+  QtCurve (C) Craig Drummond, 2007 - 2010 craig.p.drummond@gmail.com
+
+  ----
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public
+  License version 2 as published by the Free Software Foundation.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+  General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; see the file COPYING.  If not, write to
+  the Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+  Boston, MA 02110-1301, USA.
+*/
+
+/*
+  Offscreen render benchmark.
+
+  Instantiates QtCurve::Style, loads each preset (*.qtcurve), and renders every element handled by
+  drawPrimitive/drawControl/drawComplexControl into a QImage at several sizes and states. For each
+  element the time and number of heap allocations per paint are reported, both with empty caches
+  (cold) and after the caches have been primed (warm).
+
+  With -k, micro-benchmarks of the colour kernels in common.c (palette shading, and qtcAdjustPix() with each
+  of its pixel kernels) are run instead.
+
+  With -c, reading each preset via qtcReadConfig() is timed instead - both a full parse, and a read that is
+  satisfied by the binary snapshot.
+
+  Usage:
+    qtcurve-benchmark [-i iterations] [-e element] [-v] [-k] [-c] [preset file or dir ...]
+*/
+
+#include <QtGui>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <new>
+#include "qtcurve.h"
+#include "config_file.h"
+
+#ifndef QTC_BENCHMARK_THEMES_DIR
+#define QTC_BENCHMARK_THEMES_DIR "themes"
+#endif
+
+static unsigned long theAllocations=0;
+
+#ifdef __GLIBC__
+// Count every heap allocation made by the process (Qt included) by interposing malloc & co.
+extern "C"
+{
+extern void * __libc_malloc(size_t size);
+extern void * __libc_calloc(size_t num, size_t size);
+extern void * __libc_realloc(void *ptr, size_t size);
+
+void * malloc(size_t size) __THROW
+{
+    ++theAllocations;
+    return __libc_malloc(size);
+}
+
+void * calloc(size_t num, size_t size) __THROW
+{
+    ++theAllocations;
+    return __libc_calloc(num, size);
+}
+
+void * realloc(void *ptr, size_t size) __THROW
+{
+    ++theAllocations;
+    return __libc_realloc(ptr, size);
+}
+}
+#else
+// Fall back to counting C++ allocations only...
+void * operator new(size_t size)
+{
+    ++theAllocations;
+    void *p=malloc(size);
+    if(!p)
+        throw std::bad_alloc();
+    return p;
+}
+
+void * operator new[](size_t size)
+{
+    return operator new(size);
+}
+
+void operator delete(void *p) throw()
+{
+    free(p);
+}
+
+void operator delete[](void *p) throw()
+{
+    free(p);
+}
+#endif
+
+static inline qint64 nsecs()
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (((qint64)ts.tv_sec)*1000000000)+ts.tv_nsec;
+}
+
+enum ElementType
+{
+    ET_PRIMITIVE,
+    ET_CONTROL,
+    ET_COMPLEX
+};
+
+struct Element
+{
+    const char    *name;
+    ElementType   type;
+    int           id;
+    QStyleOption * (*create)();
+};
+
+template<class T> static QStyleOption * create()
+{
+    return new T;
+}
+
+static QStyleOption * createFrame()
+{
+    QStyleOptionFrameV3 *opt=new QStyleOptionFrameV3;
+    opt->lineWidth=1;
+    opt->midLineWidth=0;
+    return opt;
+}
+
+static QStyleOption * createButton()
+{
+    QStyleOptionButton *opt=new QStyleOptionButton;
+    opt->text=QLatin1String("Button");
+    return opt;
+}
+
+static QStyleOption * createHeader()
+{
+    QStyleOptionHeader *opt=new QStyleOptionHeader;
+    opt->text=QLatin1String("Header");
+    opt->section=1;
+    opt->position=QStyleOptionHeader::Middle;
+    opt->sortIndicator=QStyleOptionHeader::SortDown;
+    return opt;
+}
+
+static QStyleOption * createMenuItem()
+{
+    QStyleOptionMenuItem *opt=new QStyleOptionMenuItem;
+    opt->text=QLatin1String("Menu Item\tCtrl+M");
+    opt->menuItemType=QStyleOptionMenuItem::Normal;
+    opt->checkType=QStyleOptionMenuItem::NonExclusive;
+    opt->checked=true;
+    opt->maxIconWidth=16;
+    opt->menuRect=QRect(0, 0, 200, 400);
+    return opt;
+}
+
+static QStyleOption * createTab()
+{
+    QStyleOptionTabV3 *opt=new QStyleOptionTabV3;
+    opt->text=QLatin1String("Tab");
+    opt->shape=QTabBar::RoundedNorth;
+    opt->position=QStyleOptionTab::Middle;
+    opt->selectedPosition=QStyleOptionTab::NotAdjacent;
+    return opt;
+}
+
+static QStyleOption * createTabWidgetFrame()
+{
+    QStyleOptionTabWidgetFrameV2 *opt=new QStyleOptionTabWidgetFrameV2;
+    opt->lineWidth=1;
+    opt->shape=QTabBar::RoundedNorth;
+    opt->tabBarSize=QSize(100, 24);
+    return opt;
+}
+
+static QStyleOption * createTabBarBase()
+{
+    QStyleOptionTabBarBaseV2 *opt=new QStyleOptionTabBarBaseV2;
+    opt->shape=QTabBar::RoundedNorth;
+    return opt;
+}
+
+static QStyleOption * createProgressBar()
+{
+    QStyleOptionProgressBarV2 *opt=new QStyleOptionProgressBarV2;
+    opt->minimum=0;
+    opt->maximum=100;
+    opt->progress=40;
+    opt->textVisible=true;
+    opt->text=QLatin1String("40%");
+    opt->orientation=Qt::Horizontal;
+    return opt;
+}
+
+static QStyleOption * createViewItem()
+{
+    QStyleOptionViewItemV4 *opt=new QStyleOptionViewItemV4;
+    opt->viewItemPosition=QStyleOptionViewItemV4::OnlyOne;
+    opt->showDecorationSelected=true;
+    return opt;
+}
+
+static QStyleOption * createDockWidget()
+{
+    QStyleOptionDockWidgetV2 *opt=new QStyleOptionDockWidgetV2;
+    opt->title=QLatin1String("Dock");
+    opt->closable=opt->floatable=opt->movable=true;
+    return opt;
+}
+
+static QStyleOption * createToolBox()
+{
+    QStyleOptionToolBoxV2 *opt=new QStyleOptionToolBoxV2;
+    opt->text=QLatin1String("Page");
+    opt->position=QStyleOptionToolBoxV2::Middle;
+    return opt;
+}
+
+static QStyleOption * createToolBar()
+{
+    QStyleOptionToolBar *opt=new QStyleOptionToolBar;
+    opt->toolBarArea=Qt::TopToolBarArea;
+    opt->positionOfLine=QStyleOptionToolBar::OnlyOne;
+    opt->positionWithinLine=QStyleOptionToolBar::OnlyOne;
+    opt->lineWidth=1;
+    return opt;
+}
+
+static QStyleOption * createRubberBand()
+{
+    QStyleOptionRubberBand *opt=new QStyleOptionRubberBand;
+    opt->shape=QRubberBand::Rectangle;
+    opt->opaque=true;
+    return opt;
+}
+
+static QStyleOption * createSizeGrip()
+{
+    QStyleOptionSizeGrip *opt=new QStyleOptionSizeGrip;
+    opt->corner=Qt::BottomRightCorner;
+    return opt;
+}
+
+static QStyleOption * createSlider()
+{
+    QStyleOptionSlider *opt=new QStyleOptionSlider;
+    opt->subControls=QStyle::SC_All;
+    opt->orientation=Qt::Horizontal;
+    opt->minimum=0;
+    opt->maximum=100;
+    opt->sliderPosition=opt->sliderValue=40;
+    opt->pageStep=10;
+    opt->singleStep=1;
+    opt->tickPosition=QSlider::TicksBelow;
+    opt->tickInterval=10;
+    return opt;
+}
+
+static QStyleOption * createComboBox()
+{
+    QStyleOptionComboBox *opt=new QStyleOptionComboBox;
+    opt->subControls=QStyle::SC_All;
+    opt->currentText=QLatin1String("Combo");
+    opt->frame=true;
+    return opt;
+}
+
+static QStyleOption * createSpinBox()
+{
+    QStyleOptionSpinBox *opt=new QStyleOptionSpinBox;
+    opt->subControls=QStyle::SC_All;
+    opt->stepEnabled=QAbstractSpinBox::StepUpEnabled|QAbstractSpinBox::StepDownEnabled;
+    opt->buttonSymbols=QAbstractSpinBox::UpDownArrows;
+    opt->frame=true;
+    return opt;
+}
+
+static QStyleOption * createGroupBox()
+{
+    QStyleOptionGroupBox *opt=new QStyleOptionGroupBox;
+    opt->subControls=QStyle::SC_GroupBoxFrame|QStyle::SC_GroupBoxLabel|QStyle::SC_GroupBoxCheckBox;
+    opt->text=QLatin1String("Group");
+    opt->lineWidth=1;
+    opt->textAlignment=Qt::AlignLeft;
+    return opt;
+}
+
+static QStyleOption * createTitleBar()
+{
+    QStyleOptionTitleBar *opt=new QStyleOptionTitleBar;
+    opt->subControls=QStyle::SC_All;
+    opt->text=QLatin1String("Title");
+    opt->titleBarFlags=Qt::Window|Qt::WindowTitleHint|Qt::WindowSystemMenuHint|Qt::WindowMinMaxButtonsHint|
+                       Qt::WindowCloseButtonHint;
+    return opt;
+}
+
+static QStyleOption * createToolButton()
+{
+    QStyleOptionToolButton *opt=new QStyleOptionToolButton;
+    opt->subControls=QStyle::SC_ToolButton|QStyle::SC_ToolButtonMenu;
+    opt->features=QStyleOptionToolButton::Menu;
+    opt->text=QLatin1String("Tool");
+    opt->toolButtonStyle=Qt::ToolButtonTextOnly;
+    opt->arrowType=Qt::NoArrow;
+    return opt;
+}
+
+#define PE(A, F) { #A, ET_PRIMITIVE, QStyle::A, F }
+#define CE(A, F) { #A, ET_CONTROL,   QStyle::A, F }
+#define CC(A, F) { #A, ET_COMPLEX,   QStyle::A, F }
+
+static const Element constElements[]=
+{
+    PE(PE_IndicatorTabClose,               create<QStyleOption>),
+    PE(PE_Widget,                          create<QStyleOption>),
+    PE(PE_PanelScrollAreaCorner,           create<QStyleOption>),
+    PE(PE_IndicatorBranch,                 create<QStyleOption>),
+    PE(PE_IndicatorViewItemCheck,          createViewItem),
+    PE(PE_IndicatorHeaderArrow,            createHeader),
+    PE(PE_IndicatorArrowUp,                create<QStyleOption>),
+    PE(PE_IndicatorArrowDown,              create<QStyleOption>),
+    PE(PE_IndicatorArrowLeft,              create<QStyleOption>),
+    PE(PE_IndicatorArrowRight,             create<QStyleOption>),
+    PE(PE_IndicatorSpinMinus,              createSpinBox),
+    PE(PE_IndicatorSpinPlus,               createSpinBox),
+    PE(PE_IndicatorSpinUp,                 createSpinBox),
+    PE(PE_IndicatorSpinDown,               createSpinBox),
+    PE(PE_IndicatorToolBarSeparator,       create<QStyleOption>),
+    PE(PE_FrameGroupBox,                   createFrame),
+    PE(PE_Frame,                           createFrame),
+    PE(PE_PanelMenuBar,                    createFrame),
+    PE(PE_FrameTabBarBase,                 createTabBarBase),
+    PE(PE_FrameStatusBar,                  create<QStyleOption>),
+    PE(PE_FrameMenu,                       createFrame),
+    PE(PE_FrameDockWidget,                 createFrame),
+    PE(PE_FrameButtonTool,                 create<QStyleOption>),
+    PE(PE_PanelButtonTool,                 create<QStyleOption>),
+    PE(PE_IndicatorButtonDropDown,         create<QStyleOption>),
+    PE(PE_IndicatorDockWidgetResizeHandle, create<QStyleOption>),
+    PE(PE_PanelLineEdit,                   createFrame),
+    PE(PE_FrameLineEdit,                   createFrame),
+    PE(PE_IndicatorMenuCheckMark,          createMenuItem),
+    PE(PE_IndicatorCheckBox,               createButton),
+    PE(PE_IndicatorRadioButton,            createButton),
+    PE(PE_IndicatorToolBarHandle,          create<QStyleOption>),
+    PE(PE_FrameFocusRect,                  create<QStyleOptionFocusRect>),
+    PE(PE_FrameButtonBevel,                createButton),
+    PE(PE_PanelButtonBevel,                createButton),
+    PE(PE_PanelButtonCommand,              createButton),
+    PE(PE_FrameDefaultButton,              createButton),
+    PE(PE_FrameWindow,                     createFrame),
+    PE(PE_FrameTabWidget,                  createTabWidgetFrame),
+    PE(PE_PanelItemViewItem,               createViewItem),
+    PE(PE_PanelTipLabel,                   create<QStyleOption>),
+
+    CE(CE_CheckBox,                        createButton),
+    CE(CE_CheckBoxLabel,                   createButton),
+    CE(CE_ComboBoxLabel,                   createComboBox),
+    CE(CE_DockWidgetTitle,                 createDockWidget),
+    CE(CE_HeaderEmptyArea,                 create<QStyleOption>),
+    CE(CE_HeaderLabel,                     createHeader),
+    CE(CE_HeaderSection,                   createHeader),
+    CE(CE_MenuBarEmptyArea,                create<QStyleOption>),
+    CE(CE_MenuBarItem,                     createMenuItem),
+    CE(CE_MenuEmptyArea,                   create<QStyleOption>),
+    CE(CE_MenuHMargin,                     create<QStyleOption>),
+    CE(CE_MenuItem,                        createMenuItem),
+    CE(CE_MenuScroller,                    create<QStyleOption>),
+    CE(CE_MenuVMargin,                     create<QStyleOption>),
+    CE(CE_ProgressBarContents,             createProgressBar),
+    CE(CE_ProgressBarGroove,               createProgressBar),
+    CE(CE_ProgressBarLabel,                createProgressBar),
+    CE(CE_PushButton,                      createButton),
+    CE(CE_PushButtonBevel,                 createButton),
+    CE(CE_PushButtonLabel,                 createButton),
+    CE(CE_RadioButton,                     createButton),
+    CE(CE_RadioButtonLabel,                createButton),
+    CE(CE_RubberBand,                      createRubberBand),
+    CE(CE_ScrollBarAddLine,                createSlider),
+    CE(CE_ScrollBarAddPage,                createSlider),
+    CE(CE_ScrollBarSlider,                 createSlider),
+    CE(CE_ScrollBarSubLine,                createSlider),
+    CE(CE_ScrollBarSubPage,                createSlider),
+    CE(CE_SizeGrip,                        createSizeGrip),
+    CE(CE_Splitter,                        create<QStyleOption>),
+    CE(CE_TabBarTabLabel,                  createTab),
+    CE(CE_TabBarTabShape,                  createTab),
+    CE(CE_ToolBar,                         createToolBar),
+    CE(CE_ToolBoxTabLabel,                 createToolBox),
+    CE(CE_ToolBoxTabShape,                 createToolBox),
+    CE(CE_ToolButtonLabel,                 createToolButton),
+
+    CC(CC_ComboBox,                        createComboBox),
+    CC(CC_Dial,                            createSlider),
+    CC(CC_GroupBox,                        createGroupBox),
+    CC(CC_ScrollBar,                       createSlider),
+    CC(CC_Slider,                          createSlider),
+    CC(CC_SpinBox,                         createSpinBox),
+    CC(CC_TitleBar,                        createTitleBar),
+    CC(CC_ToolButton,                      createToolButton)
+};
+
+static const int constNumElements=sizeof(constElements)/sizeof(Element);
+
+static const QSize constSizes[]=
+{
+    QSize(16, 16),
+    QSize(96, 24),
+    QSize(320, 200)
+};
+
+static const int constNumSizes=sizeof(constSizes)/sizeof(QSize);
+
+static const struct
+{
+    const char           *name;
+    QStyle::State        state;
+} constStates[]=
+{
+    { "normal",  QStyle::State_Enabled|QStyle::State_Active|QStyle::State_Raised },
+    { "hover",   QStyle::State_Enabled|QStyle::State_Active|QStyle::State_Raised|QStyle::State_MouseOver },
+    { "sunken",  QStyle::State_Enabled|QStyle::State_Active|QStyle::State_Sunken|QStyle::State_On|QStyle::State_HasFocus|
+                 QStyle::State_Selected },
+    { "disabled", QStyle::State_Active|QStyle::State_Raised }
+};
+
+static const int constNumStates=sizeof(constStates)/sizeof(constStates[0]);
+
+struct Result
+{
+    Result() : coldNs(0), coldAllocs(0), warmNs(0), warmAllocs(0), samples(0) { }
+
+    void add(const Result &o)
+    {
+        coldNs+=o.coldNs;
+        coldAllocs+=o.coldAllocs;
+        warmNs+=o.warmNs;
+        warmAllocs+=o.warmAllocs;
+        samples+=o.samples;
+    }
+
+    double coldNs,
+           coldAllocs,
+           warmNs,
+           warmAllocs;
+    int    samples;
+};
+
+static void draw(QStyle *style, const Element &e, const QStyleOption *opt, QPainter *p, const QWidget *widget)
+{
+    switch(e.type)
+    {
+        case ET_PRIMITIVE:
+            style->drawPrimitive((QStyle::PrimitiveElement)e.id, opt, p, widget);
+            break;
+        case ET_CONTROL:
+            style->drawControl((QStyle::ControlElement)e.id, opt, p, widget);
+            break;
+        case ET_COMPLEX:
+            style->drawComplexControl((QStyle::ComplexControl)e.id, static_cast<const QStyleOptionComplex *>(opt), p, widget);
+    }
+}
+
+static Result measure(QtCurve::Style *style, const Element &e, const QSize &size, QStyle::State state, int iterations,
+                      const QWidget *widget)
+{
+    Result       res;
+    QStyleOption *opt=e.create();
+    QImage       img(size, QImage::Format_ARGB32_Premultiplied);
+
+    opt->rect=QRect(QPoint(0, 0), size);
+    opt->state=state;
+    opt->palette=QApplication::palette();
+    opt->direction=Qt::LeftToRight;
+    opt->fontMetrics=QApplication::fontMetrics();
+    if(size.width()>=size.height())
+        opt->state|=QStyle::State_Horizontal;
+    if(QStyleOptionSlider *slider=qstyleoption_cast<QStyleOptionSlider *>(opt))
+        slider->orientation=size.width()>=size.height() ? Qt::Horizontal : Qt::Vertical;
+    if(QStyleOptionProgressBarV2 *bar=qstyleoption_cast<QStyleOptionProgressBarV2 *>(opt))
+        bar->orientation=size.width()>=size.height() ? Qt::Horizontal : Qt::Vertical;
+
+    // Cold - empty the style's caches (init(false) also drops its internal pixmap cache), and Qt's...
+    style->init(false);
+    QPixmapCache::clear();
+    img.fill(0);
+    {
+        QPainter      p(&img);
+        unsigned long allocs=theAllocations;
+        qint64        start=nsecs();
+
+        draw(style, e, opt, &p, widget);
+        res.coldNs=nsecs()-start;
+        res.coldAllocs=theAllocations-allocs;
+    }
+
+    // Warm - caches have now been primed by the above...
+    {
+        QPainter      p(&img);
+        unsigned long allocs=theAllocations;
+        qint64        start=nsecs();
+
+        for(int i=0; i<iterations; ++i)
+            draw(style, e, opt, &p, widget);
+        res.warmNs=(nsecs()-start)/(double)iterations;
+        res.warmAllocs=(theAllocations-allocs)/(double)iterations;
+    }
+
+    res.samples=1;
+    delete opt;
+    return res;
+}
+
+// Shading a palette - one qtcShade() per shade, as shadeColors() used to do, against one qtcShadeColors() batch
+static void benchmarkShading(QtCurve::Style *style, int iterations)
+{
+    static const EShading   constShading[]={ SHADING_SIMPLE, SHADING_HSL, SHADING_HSV, SHADING_HCY };
+    static const char     * constShadingNames[]={ "simple", "hsl", "hsv", "hcy" };
+    static const int        constNumColors=64;
+
+    Options &opts(style->options());
+    EShading orig(opts.shading);
+    double   k[NUM_STD_SHADES+1]={ 1.05, 1.04, 0.90, 0.800, 0.830, 0.82, 1.2 };
+    QColor   vals[NUM_STD_SHADES+1],
+             cols[constNumColors];
+    int      loops=iterations*100;
+
+    for(int c=0; c<constNumColors; ++c)
+        cols[c]=QColor::fromHsv((c*37)%360, 40+(c*13)%200, 60+(c*29)%190);
+
+    printf("# Shading, ns per palette of %d shades\n", NUM_STD_SHADES+1);
+    printf("%-36s %12s %12s\n", "shading", "qtcShade", "batch");
+    for(unsigned int m=0; m<sizeof(constShading)/sizeof(EShading); ++m)
+    {
+        opts.shading=constShading[m];
+
+        qint64 start=nsecs();
+        for(int i=0; i<loops; ++i)
+            for(int s=0; s<=NUM_STD_SHADES; ++s)
+                qtcShade(&opts, cols[i%constNumColors], &vals[s], k[s]);
+        double single=(nsecs()-start)/(double)loops;
+
+        start=nsecs();
+        for(int i=0; i<loops; ++i)
+            qtcShadeColors(&opts, cols[i%constNumColors], k, NUM_STD_SHADES+1, vals);
+        double batch=(nsecs()-start)/(double)loops;
+
+        printf("%-36s %12.0f %12.0f\n", constShadingNames[m], single, batch);
+    }
+    printf("\n");
+    opts.shading=orig;
+}
+
+// Recolouring a large ARGB32 image with qtcAdjustPix(), using each of the available kernels
+static void benchmarkAdjustPix(int iterations)
+{
+    static const EPixKernel constKernels[]={ PIX_KERNEL_SCALAR, PIX_KERNEL_SSE2, PIX_KERNEL_AVX2 };
+    static const char     * constKernelNames[]={ "scalar", "sse2", "avx2" };
+    static const int        constSize=1024;
+
+    QImage orig(constSize, constSize, QImage::Format_ARGB32);
+
+    for(int y=0; y<constSize; ++y)
+    {
+        QRgb *line=(QRgb *)orig.scanLine(y);
+
+        for(int x=0; x<constSize; ++x)
+            line[x]=qRgba(x&0xFF, (x+y)&0xFF, y&0xFF, (x*y)&0xFF);
+    }
+
+    printf("# qtcAdjustPix, %dx%d ARGB32\n", constSize, constSize);
+    printf("%-36s %12s %12s\n", "kernel", "us/image", "Mpixel/s");
+    for(unsigned int k=0; k<sizeof(constKernels)/sizeof(EPixKernel); ++k)
+    {
+        if(qtcSetPixKernel(constKernels[k])!=constKernels[k])
+        {
+            printf("%-36s %12s\n", constKernelNames[k], "n/a");
+            continue;
+        }
+
+        // Recolouring the already recoloured image costs the same, so there is no need to restore it each time
+        QImage img(orig.copy());
+        qint64 start=nsecs();
+
+        for(int i=0; i<iterations; ++i)
+            qtcAdjustPix(img.bits(), 4, img.width(), img.height(), img.bytesPerLine(), 128, 160, 200, 1.0);
+
+        double ns=(nsecs()-start)/(double)iterations;
+
+        printf("%-36s %12.0f %12.1f\n", constKernelNames[k], ns/1000.0, (constSize*constSize)/(ns/1000.0));
+    }
+    printf("\n");
+    qtcSetPixKernel(PIX_KERNEL_AUTO);
+}
+
+// Reading each preset with qtcReadConfig(). Passing default options bypasses the binary snapshot, so that
+// the text parser itself is measured.
+static void benchmarkConfig(const QStringList &presets, int iterations)
+{
+    Options defOpts;
+    double  totalParse(0),
+            totalSnapshot(0);
+
+    qtcDefaultSettings(&defOpts);
+
+    printf("# qtcReadConfig\n");
+    printf("%-36s %12s %12s %12s\n", "preset", "parse us", "parse allocs", "snapshot us");
+    foreach(const QString &preset, presets)
+    {
+        Options       opts;
+        unsigned long allocs(theAllocations);
+        qint64        start(nsecs());
+
+        for(int i=0; i<iterations; ++i)
+            qtcReadConfig(preset, &opts, &defOpts);
+
+        double parseNs=(nsecs()-start)/(double)iterations,
+               parseAllocs=(theAllocations-allocs)/(double)iterations;
+
+        // First read writes the snapshot, the rest then use it
+        qtcReadConfig(preset, &opts);
+        start=nsecs();
+        for(int i=0; i<iterations; ++i)
+            qtcReadConfig(preset, &opts);
+
+        double snapshotNs=(nsecs()-start)/(double)iterations;
+
+        printf("%-36s %12.1f %12.1f %12.1f\n", qPrintable(QFileInfo(preset).fileName()), parseNs/1000.0, parseAllocs,
+               snapshotNs/1000.0);
+        totalParse+=parseNs;
+        totalSnapshot+=snapshotNs;
+    }
+    printf("%-36s %12.1f %12s %12.1f\n\n", "average", totalParse/presets.count()/1000.0, "",
+           totalSnapshot/presets.count()/1000.0);
+}
+
+static QStringList presetFiles(const QStringList &args)
+{
+    QStringList files;
+
+    foreach(const QString &arg, args)
+    {
+        QFileInfo info(arg);
+
+        if(info.isDir())
+            foreach(const QFileInfo &f, QDir(arg).entryInfoList(QStringList() << QLatin1String("*.qtcurve"), QDir::Files,
+                                                                 QDir::Name))
+                files.append(f.absoluteFilePath());
+        else if(info.exists())
+            files.append(info.absoluteFilePath());
+        else
+            fprintf(stderr, "Ignoring %s - no such file\n", qPrintable(arg));
+    }
+    return files;
+}
+
+static void usage(const char *app)
+{
+    fprintf(stderr, "Usage: %s [-i iterations] [-e element] [-v] [-k] [-c] [preset file or dir ...]\n"
+                    "    -i N    Number of warm paints per sample (default 50)\n"
+                    "    -e STR  Only benchmark elements whose name contains STR\n"
+                    "    -v      Print each size/state sample, not just per-element totals\n"
+                    "    -k      Benchmark the colour kernels (shading, etc.) instead of the elements\n"
+                    "    -c      Benchmark reading the presets' config files instead of the elements\n"
+                    "Presets default to %s\n", app, QTC_BENCHMARK_THEMES_DIR);
+}
+
+int main(int argc, char **argv)
+{
+    QApplication app(argc, argv);
+    QStringList  args(app.arguments()),
+                 presets;
+    QString      filter;
+    int          iterations=50;
+    bool         verbose=false,
+                 kernels=false,
+                 config=false;
+
+    for(int i=1; i<args.count(); ++i)
+    {
+        const QString &arg(args[i]);
+
+        if(QLatin1String("-i")==arg && i+1<args.count())
+            iterations=qMax(1, args[++i].toInt());
+        else if(QLatin1String("-e")==arg && i+1<args.count())
+            filter=args[++i];
+        else if(QLatin1String("-v")==arg)
+            verbose=true;
+        else if(QLatin1String("-k")==arg)
+            kernels=true;
+        else if(QLatin1String("-c")==arg)
+            config=true;
+        else if(arg.startsWith('-'))
+        {
+            usage(argv[0]);
+            return 1;
+        }
+        else
+            presets.append(arg);
+    }
+
+    if(presets.isEmpty())
+        presets.append(QLatin1String(QTC_BENCHMARK_THEMES_DIR));
+    presets=presetFiles(presets);
+    if(presets.isEmpty())
+    {
+        usage(argv[0]);
+        return 1;
+    }
+
+    QtCurve::Style *style=new QtCurve::Style;
+    QWidget        widget;
+    Result         totals[constNumElements];
+
+    QApplication::setStyle(style);
+    widget.resize(320, 200);
+
+    if(kernels || config)
+    {
+        if(kernels)
+        {
+            benchmarkShading(style, iterations);
+            benchmarkAdjustPix(iterations);
+        }
+        if(config)
+            benchmarkConfig(presets, iterations);
+        return 0;
+    }
+
+    foreach(const QString &preset, presets)
+    {
+        // Style::init() reads its settings via qtcReadConfig(), which honours QTCURVE_CONFIG_FILE...
+        qputenv("QTCURVE_CONFIG_FILE", QFile::encodeName(preset));
+        style->init(false);
+
+        unsigned long shadeHits(style->shadeCache().hits()),
+                      shadeMisses(style->shadeCache().misses());
+
+        printf("# %s\n", qPrintable(QFileInfo(preset).fileName()));
+        printf("%-36s %12s %12s %12s %12s\n", "element", "cold ns/op", "cold allocs", "warm ns/op", "warm allocs");
+
+        for(int e=0; e<constNumElements; ++e)
+        {
+            const Element &element(constElements[e]);
+
+            if(!filter.isEmpty() && !QString(QLatin1String(element.name)).contains(filter, Qt::CaseInsensitive))
+                continue;
+
+            Result presetTotal;
+
+            for(int sz=0; sz<constNumSizes; ++sz)
+                for(int st=0; st<constNumStates; ++st)
+                {
+                    Result r(measure(style, element, constSizes[sz], constStates[st].state, iterations, &widget));
+
+                    if(verbose)
+                        printf("  %-34s %4dx%-4d %-8s %12.0f %12.0f %12.0f %12.1f\n", element.name,
+                               constSizes[sz].width(), constSizes[sz].height(), constStates[st].name,
+                               r.coldNs, r.coldAllocs, r.warmNs, r.warmAllocs);
+                    presetTotal.add(r);
+                }
+
+            printf("%-36s %12.0f %12.1f %12.0f %12.1f\n", element.name,
+                   presetTotal.coldNs/presetTotal.samples, presetTotal.coldAllocs/presetTotal.samples,
+                   presetTotal.warmNs/presetTotal.samples, presetTotal.warmAllocs/presetTotal.samples);
+            totals[e].add(presetTotal);
+        }
+        printf("shade cache: %lu hits, %lu misses\n\n", style->shadeCache().hits()-shadeHits,
+               style->shadeCache().misses()-shadeMisses);
+    }
+
+    // Overall ranking, most expensive (warm) first - this is what is paid on every repaint...
+    QList<QPair<double, int> > ranking;
+
+    for(int e=0; e<constNumElements; ++e)
+        if(totals[e].samples)
+            ranking.append(QPair<double, int>(-(totals[e].warmNs/totals[e].samples), e));
+    qSort(ranking);
+
+    printf("# All presets, sorted by warm cost\n");
+    printf("%-36s %12s %12s %12s %12s\n", "element", "cold ns/op", "cold allocs", "warm ns/op", "warm allocs");
+    for(int i=0; i<ranking.count(); ++i)
+    {
+        const Result &r(totals[ranking[i].second]);
+
+        printf("%-36s %12.0f %12.1f %12.0f %12.1f\n", constElements[ranking[i].second].name,
+               r.coldNs/r.samples, r.coldAllocs/r.samples, r.warmNs/r.samples, r.warmAllocs/r.samples);
+    }
+
+    return 0;
+}
@@ -0,0 +1,206 @@
+/*
+  QtCurve (C) Craig Drummond, 2007 - 2010 craig.p.drummond@gmail.com
+
+  ----
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public
+  License version 2 as published by the Free Software Foundation.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+  General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; see the file COPYING.  If not, write to
+  the Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+  Boston, MA 02110-1301, USA.
+*/
+
+#include "bgndimageloader.h"
+#include "config_file.h"
+#include <QtCore/QCryptographicHash>
+#include <QtCore/QDateTime>
+#include <QtCore/QDir>
+#include <QtCore/QFile>
+#include <QtCore/QFileInfo>
+#include <QtCore/QtConcurrentRun>
+#include <QtGui/QApplication>
+#include <QtGui/QPixmap>
+#include <QtGui/QWidget>
+#include <stdio.h>
+
+namespace QtCurve
+{
+
+static bool isSvg(const QString &file)
+{
+    return file.endsWith(".svg", Qt::CaseInsensitive) || file.endsWith(".svgz", Qt::CaseInsensitive);
+}
+
+// Cache entries not (re)written for this many days are removed - e.g. those for images that are no longer used.
+static const int constMaxCacheAge=30;
+
+// Cache files are named bgnd-<MD5 of path>-<modification time>-<width>x<height>.png
+static QString cacheFilePrefix(const QString &file)
+{
+    return QLatin1String("bgnd-")+
+           QString::fromLatin1(QCryptographicHash::hash(QFile::encodeName(file), QCryptographicHash::Md5).toHex())+
+           QLatin1Char('-');
+}
+
+static QString cacheFileName(const QString &file, int width, int height, const QString &cacheDir)
+{
+    QFileInfo info(file);
+
+    if(!info.exists())
+        return QString();
+
+    return cacheDir+cacheFilePrefix(file)+QString().sprintf("%llx-%dx%d.png",
+                                                            (unsigned long long)info.lastModified().toTime_t(),
+                                                            width, height);
+}
+
+// Removes the entries for previous versions of the image (as its modification time is part of the name), and any
+// entries that have not been written for a while.
+static void pruneCache(const QString &file, const QString &cacheFile, const QString &cacheDir)
+{
+    QString       prefix(cacheFilePrefix(file)),
+                  current(QFileInfo(cacheFile).fileName());
+    QDateTime     oldest(QDateTime::currentDateTime().addDays(-constMaxCacheAge));
+    QFileInfoList entries(QDir(cacheDir).entryInfoList(QStringList() << QLatin1String("bgnd-*.png"), QDir::Files));
+
+    // The current entry's name up to, and including, the modification time...
+    current=current.left(current.indexOf(QLatin1Char('-'), prefix.length())+1);
+
+    foreach(const QFileInfo &entry, entries)
+        if((entry.fileName().startsWith(prefix) && !entry.fileName().startsWith(current)) ||
+           entry.lastModified()<oldest)
+            QFile::remove(entry.absoluteFilePath());
+}
+
+static void saveToCache(const QImage &img, const QString &file, const QString &cacheFile, const QString &cacheDir)
+{
+    if(!img.isNull() && !cacheFile.isEmpty() && QDir().mkpath(cacheDir))
+    {
+        // Write to a temporary file, and then rename, so that another process never reads a partial image.
+        QString tmpFile(cacheFile+QString().sprintf(".%lld", (long long)QCoreApplication::applicationPid()));
+
+        if(img.save(tmpFile, "PNG") && 0==rename(QFile::encodeName(tmpFile).constData(),
+                                                 QFile::encodeName(cacheFile).constData()))
+            pruneCache(file, cacheFile, cacheDir);
+        else
+            QFile::remove(tmpFile);
+    }
+}
+
+// Runs in a worker thread - so must only use QImage, and must not call qtcConfDir() (which uses a static buffer).
+// SVGs may contain text, and fonts cannot be used outside of the GUI thread - so for these only the disk cache is
+// checked here, and if this misses they are rendered in loaded().
+static QImage loadImage(const QString &file, int width, int height, const QString &cacheDir)
+{
+    // Unscaled images are just loaded as-is, there is nothing to gain from caching them. (SVGs are only rendered
+    // when scaled.)
+    if(0==width)
+        return qtcRenderBgndImage(file, width, height);
+
+    QString cacheFile(cacheFileName(file, width, height, cacheDir));
+    QImage  img;
+
+    if(cacheFile.isEmpty())
+        return img;
+
+    if(img.load(cacheFile, "PNG") && img.width()==width && img.height()==height)
+        return img;
+
+    if(isSvg(file))
+        return QImage();
+
+    img=qtcRenderBgndImage(file, width, height);
+    saveToCache(img, file, cacheFile, cacheDir);
+    return img;
+}
+
+BgndImageLoader::BgndImageLoader(QObject *parent)
+               : QObject(parent)
+{
+}
+
+BgndImageLoader::~BgndImageLoader()
+{
+    // Jobs must be waited for, as the style plugin may be about to be unloaded.
+    foreach(QFutureWatcher<QImage> *watcher, itsJobs.keys())
+        watcher->waitForFinished();
+}
+
+void BgndImageLoader::load(QtCImage *img)
+{
+    if(IMG_FILE!=img->type || img->loaded || !qtcBgndImageSizeValid(img))
+        return;
+
+    // Mark as loaded now, so that painting does not try to load it again - pixmap stays null until the job completes.
+    img->loaded=true;
+    img->pixmap.img=QPixmap();
+
+    QString file(qtcBgndImageFile(img->pixmap.file));
+
+    if(file.isEmpty())
+        return;
+
+    QFutureWatcher<QImage> *watcher=new QFutureWatcher<QImage>(this);
+    Job                    job;
+
+    job.img=img;
+    job.file=img->pixmap.file;
+    job.path=file;
+    job.width=img->width;
+    job.height=img->height;
+    itsJobs.insert(watcher, job);
+    connect(watcher, SIGNAL(finished()), SLOT(loaded()));
+    watcher->setFuture(QtConcurrent::run(loadImage, file, img->width, img->height,
+                                         QString(qtcConfDir())+QLatin1String("cache/")));
+}
+
+void BgndImageLoader::cancel()
+{
+    // Running jobs cannot be interrupted, so just forget which image they were for. Their watchers are kept
+    // until they finish, so that the destructor can wait for them.
+    QMap<QFutureWatcher<QImage> *, Job>::Iterator it(itsJobs.begin()),
+                                                   end(itsJobs.end());
+
+    for(; it!=end; ++it)
+        it.value().img=0L;
+}
+
+void BgndImageLoader::loaded()
+{
+    QFutureWatcher<QImage> *watcher=static_cast<QFutureWatcher<QImage> *>(sender());
+    Job                    job(itsJobs.take(watcher));
+    QtCImage               *img=job.img;
+
+    if(img && img->pixmap.file==job.file && img->width==job.width && img->height==job.height)
+    {
+        QImage result(watcher->result());
+
+        if(result.isNull() && 0!=job.width && isSvg(job.path))
+        {
+            QString cacheDir(QString(qtcConfDir())+QLatin1String("cache/"));
+
+            result=qtcRenderBgndImage(job.path, job.width, job.height);
+            saveToCache(result, job.path, cacheFileName(job.path, job.width, job.height, cacheDir), cacheDir);
+        }
+
+        if(!result.isNull())
+        {
+            img->pixmap.img=QPixmap::fromImage(result);
+
+            foreach(QWidget *widget, QApplication::topLevelWidgets())
+                if(widget->isVisible())
+                    widget->update();
+        }
+    }
+    watcher->deleteLater();
+}
+
+}
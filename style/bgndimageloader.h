@@ -0,0 +1,74 @@
+#ifndef __QTC_BGND_IMAGE_LOADER_H__
+#define __QTC_BGND_IMAGE_LOADER_H__
+
+/*
+  QtCurve (C) Craig Drummond, 2007 - 2010 craig.p.drummond@gmail.com
+
+  ----
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public
+  License version 2 as published by the Free Software Foundation.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+  General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; see the file COPYING.  If not, write to
+  the Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+  Boston, MA 02110-1301, USA.
+*/
+
+#include <QtCore/QObject>
+#include <QtCore/QMap>
+#include <QtCore/QFutureWatcher>
+#include <QtGui/QImage>
+#include "common.h"
+
+namespace QtCurve
+{
+    // Loads (and scales) IMG_FILE background images in a worker thread, so that neither style init nor the first
+    // paint of a window blocks on decoding. Scaled results are also stored in a disk cache, keyed on the file's path,
+    // modification time, and the target size - so subsequent application starts just need to read back a PNG. SVGs
+    // are rasterised in the GUI thread (as they may use fonts), but their cached PNG is still read in the worker.
+    // Until an image has loaded, it is simply not drawn.
+    class BgndImageLoader : public QObject
+    {
+        Q_OBJECT
+
+        public:
+
+        BgndImageLoader(QObject *parent);
+        virtual ~BgndImageLoader();
+
+        // Start loading img, if it is a file image that has not already been loaded (or started loading).
+        void load(QtCImage *img);
+        // Forget any pending loads - their results will be discarded. Called when the settings are re-read.
+        void cancel();
+
+        private Q_SLOTS:
+
+        void loaded();
+
+        private:
+
+        // What a job was started for - so that a job that finishes after the settings have changed (e.g. the config
+        // dialog's preview re-using the same QtCImage for a new file) does not set the wrong image.
+        struct Job
+        {
+            Job() : img(0L), width(0), height(0) { }
+
+            QtCImage *img;
+            QString  file,
+                     path;      // file, as resolved by qtcBgndImageFile()
+            int      width,
+                     height;
+        };
+
+        QMap<QFutureWatcher<QImage> *, Job> itsJobs;
+    };
+}
+
+#endif
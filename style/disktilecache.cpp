@@ -0,0 +1,278 @@
+/*
+  QtCurve (C) Craig Drummond, 2007 - 2010 craig.p.drummond@gmail.com
+
+  ----
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public
+  License version 2 as published by the Free Software Foundation.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+  General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; see the file COPYING.  If not, write to
+  the Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+  Boston, MA 02110-1301, USA.
+*/
+
+#include "disktilecache.h"
+#include <QtCore/QCoreApplication>
+#include <QtCore/QDir>
+#include <QtCore/QFileInfo>
+#include <QtCore/QVector>
+#include <QtCore/QtAlgorithms>
+#include <QtCore/QSysInfo>
+#include <QtGui/QImage>
+#include <string.h>
+#include <stdio.h>
+
+namespace QtCurve
+{
+
+static const char    constMagic[8]     = { 'Q', 't', 'C', 'T', 'i', 'l', 'e', 's' };
+static const quint32 constVersion      = 2;
+static const qint64  constMaxFileSize  = 8*1024*1024;
+static const int     constSlicedFlag   = 0x01;
+static const int     constHorizFlag    = 0x02;
+
+struct Header
+{
+    char    magic[8];
+    quint32 version,
+            byteOrder,  // Tiles are stored as native ARGB32, so a file is only valid for the same byte order
+            count,
+            pad;
+};
+
+void DiskTileCache::open(const QString &fileName)
+{
+    close();
+    itsFileName=fileName;
+    itsFile.setFileName(fileName);
+
+    if(!itsFile.open(QIODevice::ReadOnly) || itsFile.size()<(qint64)sizeof(Header))
+        return;
+
+    itsSize=itsFile.size();
+    itsData=itsFile.map(0, itsSize);
+
+    if(!itsData)
+        return;
+
+    const Header *header=(const Header *)itsData;
+
+    if(0!=memcmp(header->magic, constMagic, sizeof(constMagic)) || constVersion!=header->version ||
+       (quint32)QSysInfo::ByteOrder!=header->byteOrder ||
+       (qint64)(sizeof(Header)+(header->count*sizeof(Entry)))>itsSize)
+        return;
+
+    const Entry *entry=(const Entry *)(itsData+sizeof(Header));
+
+    for(quint32 i=0; i<header->count; ++i, ++entry)
+    {
+        bool ok(true);
+
+        for(int im=0; im<3 && ok; ++im)
+            ok=(qint64)entry->images[im].offset+((qint64)entry->images[im].width*entry->images[im].height*4)<=itsSize;
+
+        if(ok)
+            itsEntries.insert(QtcKey(entry->high, entry->low), entry);
+    }
+}
+
+void DiskTileCache::close()
+{
+    if(isOpen())
+        save();
+
+    itsEntries.clear();
+    itsHits.clear();
+    itsNew.clear();
+    itsNewCost=0;
+    if(itsData)
+        itsFile.unmap((uchar *)itsData);
+    itsData=0L;
+    itsFile.close();
+    itsFileName=QString();
+}
+
+bool DiskTileCache::find(const QtcKey &key, TileSet &tiles) const
+{
+    const Entry *entry=itsEntries.value(key);
+
+    if(!entry)
+        return false;
+
+    itsHits[key]++;
+
+    tiles=entry->flags&constSlicedFlag
+            ? TileSet(pixmap(entry->images[0]), pixmap(entry->images[1]), pixmap(entry->images[2]),
+                      entry->flags&constHorizFlag, entry->endSize)
+            : TileSet(pixmap(entry->images[1]));
+    return true;
+}
+
+void DiskTileCache::add(const QtcKey &key, const TileSet &tiles)
+{
+    int cost(tiles.cost());
+
+    if(isOpen() && itsNewCost+cost<constMaxFileSize && !itsEntries.contains(key) && !itsNew.contains(key))
+    {
+        itsNew.insert(key, tiles);
+        itsNewCost+=cost;
+    }
+}
+
+QPixmap DiskTileCache::pixmap(const Image &img) const
+{
+    if(0==img.width || 0==img.height)
+        return QPixmap();
+
+    // QImage just wraps the mapped data, so the only copy is the one to the pixmap
+    return QPixmap::fromImage(QImage(itsData+img.offset, img.width, img.height, img.width*4,
+                                     QImage::Format_ARGB32_Premultiplied));
+}
+
+void DiskTileCache::appendImage(const QImage &img, Image &entry, QByteArray &data)
+{
+    entry.width=img.width();
+    entry.height=img.height();
+    entry.offset=data.size();
+
+    for(int y=0; y<img.height(); ++y)
+        data.append((const char *)img.constScanLine(y), img.width()*4);
+}
+
+void DiskTileCache::save()
+{
+    if(itsNew.isEmpty())
+        return;
+
+    QVector<Candidate> candidates;
+    QVector<Entry>     entries;
+    QByteArray         data;
+
+    candidates.reserve(itsEntries.count()+itsNew.count());
+
+    // Existing tiles keep half of their previous hits, plus those from this run - so tiles that are no longer used
+    // (e.g. those rendered for a window size that is never seen again) age out. New tiles count as one hit.
+    QHash<QtcKey, const Entry *>::ConstIterator it(itsEntries.constBegin()),
+                                                end(itsEntries.constEnd());
+
+    for(; it!=end; ++it)
+    {
+        Candidate c;
+
+        c.key=it.key();
+        c.hits=(it.value()->hits/2)+itsHits.value(it.key());
+        c.bytes=0;
+        for(int im=0; im<3; ++im)
+            c.bytes+=(qint64)it.value()->images[im].width*it.value()->images[im].height*4;
+        c.entry=it.value();
+        c.tiles=0L;
+        candidates.append(c);
+    }
+
+    QHash<QtcKey, TileSet>::ConstIterator nIt(itsNew.constBegin()),
+                                          nEnd(itsNew.constEnd());
+
+    for(; nIt!=nEnd; ++nIt)
+    {
+        Candidate c;
+
+        c.key=nIt.key();
+        c.hits=1;
+        c.bytes=nIt.value().cost();
+        c.entry=0L;
+        c.tiles=&nIt.value();
+        candidates.append(c);
+    }
+
+    // Stable, so that for equal hits existing tiles are kept in preference to new ones
+    qStableSort(candidates.begin(), candidates.end(), moreHits);
+
+    qint64 total(0);
+
+    for(int i=0; i<candidates.count(); ++i)
+    {
+        const Candidate &c(candidates[i]);
+
+        if(total+c.bytes>constMaxFileSize)
+            continue;
+        total+=c.bytes;
+
+        if(c.entry)
+        {
+            Entry entry(*c.entry);
+
+            entry.hits=c.hits;
+            for(int im=0; im<3; ++im)
+                appendImage(QImage(itsData+entry.images[im].offset, entry.images[im].width, entry.images[im].height,
+                                   entry.images[im].width*4, QImage::Format_ARGB32_Premultiplied),
+                            entry.images[im], data);
+            entries.append(entry);
+        }
+        else
+        {
+            const TileSet &tiles(*c.tiles);
+            Entry         entry;
+
+            memset(&entry, 0, sizeof(Entry));
+            entry.high=c.key.high;
+            entry.low=c.key.low;
+            entry.hits=c.hits;
+            if(tiles.isSliced())
+            {
+                entry.flags=constSlicedFlag|(tiles.isHorizontal() ? constHorizFlag : 0);
+                entry.endSize=tiles.endSize();
+                appendImage(tiles.start().toImage().convertToFormat(QImage::Format_ARGB32_Premultiplied),
+                            entry.images[0], data);
+                appendImage(tiles.end().toImage().convertToFormat(QImage::Format_ARGB32_Premultiplied),
+                            entry.images[2], data);
+            }
+            appendImage(tiles.pixmap().toImage().convertToFormat(QImage::Format_ARGB32_Premultiplied),
+                        entry.images[1], data);
+            entries.append(entry);
+        }
+    }
+
+    // Image offsets were relative to the start of the data, which follows the header and the index
+    quint32 dataStart(sizeof(Header)+(entries.count()*sizeof(Entry)));
+
+    for(int e=0; e<entries.count(); ++e)
+        for(int im=0; im<3; ++im)
+            entries[e].images[im].offset+=dataStart;
+
+    Header header;
+
+    memcpy(header.magic, constMagic, sizeof(constMagic));
+    header.version=constVersion;
+    header.byteOrder=QSysInfo::ByteOrder;
+    header.count=entries.count();
+    header.pad=0;
+
+    // Other applications may be writing the same file - so write to a temporary file, and rename over the
+    // original, so that a reader never sees a partial cache. Last writer wins.
+    if(!QDir().mkpath(QFileInfo(itsFileName).absolutePath()))
+        return;
+
+    QString tmpName(itsFileName+QString().sprintf(".%lld", (long long)QCoreApplication::applicationPid()));
+    QFile   tmp(tmpName);
+
+    if(tmp.open(QIODevice::WriteOnly))
+    {
+        bool ok=tmp.write((const char *)&header, sizeof(Header))==(qint64)sizeof(Header) &&
+                tmp.write((const char *)entries.constData(), entries.count()*sizeof(Entry))==
+                    (qint64)(entries.count()*sizeof(Entry)) &&
+                tmp.write(data)==data.size();
+
+        tmp.close();
+        if(!ok || 0!=rename(QFile::encodeName(tmpName).constData(), QFile::encodeName(itsFileName).constData()))
+            QFile::remove(tmpName);
+    }
+}
+
+}
@@ -0,0 +1,100 @@
+#ifndef __QTC_DISK_TILE_CACHE_H__
+#define __QTC_DISK_TILE_CACHE_H__
+
+/*
+  QtCurve (C) Craig Drummond, 2007 - 2010 craig.p.drummond@gmail.com
+
+  ----
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public
+  License version 2 as published by the Free Software Foundation.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+  General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; see the file COPYING.  If not, write to
+  the Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+  Boston, MA 02110-1301, USA.
+*/
+
+#include <QtCore/QByteArray>
+#include <QtCore/QFile>
+#include <QtCore/QHash>
+#include <QtCore/QString>
+#include "qtckey.h"
+#include "tileset.h"
+
+class QImage;
+
+namespace QtCurve
+{
+    // Pre-rendered tiles, persisted across application runs. There is one file per theme (the file name is a hash
+    // of everything that affects rendering - see Style::openTileCaches()), holding ARGB32 tiles indexed by
+    // their QtcKey. The file is mmap-ed, so reading back a tile just needs a QPixmap::fromImage(). Tiles rendered
+    // during this run are written out, merged with the existing ones, when the cache is closed. If the merged set
+    // is too large, the tiles that have been looked up least are dropped.
+    class DiskTileCache
+    {
+        public:
+
+        DiskTileCache() : itsData(0L), itsSize(0), itsNewCost(0) { }
+        ~DiskTileCache() { close(); }
+
+        void open(const QString &fileName);
+        void close();
+        bool isOpen() const { return !itsFileName.isEmpty(); }
+
+        bool find(const QtcKey &key, TileSet &tiles) const;
+        void add(const QtcKey &key, const TileSet &tiles);
+        // Record a use of a tile that was found in another tier (i.e. the shared cache), so it is not aged out
+        void touch(const QtcKey &key) const { if(itsEntries.contains(key)) itsHits[key]++; }
+
+        private:
+
+        struct Image
+        {
+            quint32 width,
+                    height,
+                    offset;
+        };
+
+        struct Entry
+        {
+            quint64 high,
+                    low;
+            quint32 flags,
+                    endSize,
+                    hits;       // Decayed count of lookups - used to decide what to drop when the file is full
+            Image   images[3];  // start, middle, end - only middle is used for unsliced sets
+        };
+
+        struct Candidate
+        {
+            QtcKey        key;
+            quint32       hits;
+            qint64        bytes;
+            const Entry   *entry;
+            const TileSet *tiles;
+        };
+
+        QPixmap     pixmap(const Image &img) const;
+        void        save();
+        static void appendImage(const QImage &img, Image &entry, QByteArray &data);
+        static bool moreHits(const Candidate &a, const Candidate &b) { return a.hits>b.hits; }
+
+        QString                      itsFileName;
+        QFile                        itsFile;
+        const uchar                  *itsData;
+        qint64                       itsSize;
+        QHash<QtcKey, const Entry *> itsEntries;
+        mutable QHash<QtcKey, quint32> itsHits;
+        QHash<QtcKey, TileSet>       itsNew;
+        int                          itsNewCost;
+    };
+}
+
+#endif
@@ -0,0 +1,170 @@
+#ifndef __QTC_PIXMAP_CACHE_H__
+#define __QTC_PIXMAP_CACHE_H__
+
+/*
+  QtCurve (C) Craig Drummond, 2007 - 2010 craig.p.drummond@gmail.com
+
+  ----
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public
+  License version 2 as published by the Free Software Foundation.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+  General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; see the file COPYING.  If not, write to
+  the Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+  Boston, MA 02110-1301, USA.
+*/
+
+#include <QtCore/QCache>
+#include <QtCore/QHash>
+#include <QtGui/QPixmap>
+#include "config.h"
+#include "qtckey.h"
+#include "tileset.h"
+#ifdef QTC_ENABLE_DISK_TILE_CACHE
+#include "disktilecache.h"
+#endif
+#ifdef QTC_ENABLE_SHARED_TILE_CACHE
+#include "sharedtilecache.h"
+#endif
+
+namespace QtCurve
+{
+    // Single pixmap cache used for all of the style's tiles. Entries are either plain pixmaps, or pixmaps
+    // pre-sliced into a TileSet. Lookups return an (implicitly shared) copy of the cached entry - so a hit
+    // does not allocate, and the result stays valid even if a later insert evicts the entry. Cost is in bytes.
+    //
+    // If enabled, misses are then looked up in the cache shared with other processes, and then in the disk cache.
+    // Entries whose key depends upon a widget's exact size (and so would only pile up in those caches, as the user
+    // resizes) should be found and inserted with persistent=false - these only ever live in memory.
+    class PixmapCache
+    {
+        public:
+
+        PixmapCache(int maxCost) : itsCache(maxCost) { }
+
+        bool find(const QtcKey &key, TileSet &tiles) const
+        {
+            const TileSet *cached=itsCache.object(key);
+
+            if(cached)
+            {
+                tiles=*cached;
+                return true;
+            }
+            return findBacking(key, tiles);
+        }
+
+        bool find(const QtcKey &key, QPixmap &pix, bool persistent=true) const
+        {
+            const TileSet *cached=itsCache.object(key);
+
+            if(cached)
+            {
+                pix=cached->pixmap();
+                return true;
+            }
+
+            TileSet tiles;
+
+            if(persistent && findBacking(key, tiles))
+            {
+                pix=tiles.pixmap();
+                return true;
+            }
+            return false;
+        }
+
+        void insert(const QtcKey &key, const TileSet &tiles) const
+        {
+            insertMemory(key, tiles);
+#ifdef QTC_ENABLE_SHARED_TILE_CACHE
+            itsSharedCache.add(key, tiles);
+#endif
+#ifdef QTC_ENABLE_DISK_TILE_CACHE
+            itsDiskCache.add(key, tiles);
+#endif
+        }
+
+        void insert(const QtcKey &key, const QPixmap &pix, bool persistent=true) const
+        {
+            if(persistent)
+                insert(key, TileSet(pix));
+            else
+                insertMemory(key, TileSet(pix));
+        }
+
+        // Clearing also closes the shared and disk caches (writing out any new tiles), as their contents are only
+        // valid for the settings and palette they were opened for.
+        void clear() const
+        {
+            itsCache.clear();
+#ifdef QTC_ENABLE_SHARED_TILE_CACHE
+            itsSharedCache.close();
+#endif
+#ifdef QTC_ENABLE_DISK_TILE_CACHE
+            itsDiskCache.close();
+#endif
+        }
+
+#ifdef QTC_ENABLE_DISK_TILE_CACHE
+        void openDiskCache(const QString &fileName) const { itsDiskCache.open(fileName); }
+#endif
+#ifdef QTC_ENABLE_SHARED_TILE_CACHE
+        void openSharedCache(const QString &hash) const   { itsSharedCache.open(hash); }
+#endif
+
+        private:
+
+        void insertMemory(const QtcKey &key, const TileSet &tiles) const
+        {
+            int cost(tiles.cost());
+
+            if(cost<itsCache.maxCost())
+                itsCache.insert(key, new TileSet(tiles), cost);
+        }
+
+        bool findBacking(const QtcKey &key, TileSet &tiles) const
+        {
+#ifdef QTC_ENABLE_SHARED_TILE_CACHE
+            if(itsSharedCache.find(key, tiles))
+            {
+                insertMemory(key, tiles);
+#ifdef QTC_ENABLE_DISK_TILE_CACHE
+                itsDiskCache.touch(key);
+#endif
+                return true;
+            }
+#endif
+#ifdef QTC_ENABLE_DISK_TILE_CACHE
+            if(itsDiskCache.find(key, tiles))
+            {
+                insertMemory(key, tiles);
+#ifdef QTC_ENABLE_SHARED_TILE_CACHE
+                itsSharedCache.add(key, tiles);
+#endif
+                return true;
+            }
+#endif
+            Q_UNUSED(key)
+            Q_UNUSED(tiles)
+            return false;
+        }
+
+        mutable QCache<QtcKey, TileSet> itsCache;
+#ifdef QTC_ENABLE_DISK_TILE_CACHE
+        mutable DiskTileCache           itsDiskCache;
+#endif
+#ifdef QTC_ENABLE_SHARED_TILE_CACHE
+        mutable SharedTileCache         itsSharedCache;
+#endif
+    };
+}
+
+#endif
@@ -0,0 +1,43 @@
+#ifndef __QTC_KEY_H__
+#define __QTC_KEY_H__
+
+/*
+  QtCurve (C) Craig Drummond, 2007 - 2010 craig.p.drummond@gmail.com
+
+  ----
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public
+  License version 2 as published by the Free Software Foundation.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+  General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; see the file COPYING.  If not, write to
+  the Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+  Boston, MA 02110-1301, USA.
+*/
+
+#include <QtCore/QHash>
+
+// Cache key. The values are bit-packed by the createKey() functions in qtcurve.cpp, so building a key never
+// allocates or formats a string.
+struct QtcKey
+{
+    QtcKey(quint64 h=0, quint64 l=0) : high(h), low(l) { }
+
+    bool operator==(const QtcKey &o) const { return low==o.low && high==o.high; }
+
+    quint64 high,
+            low;
+};
+
+inline uint qHash(const QtcKey &key)
+{
+    return qHash(key.low)^(qHash(key.high)*31);
+}
+
+#endif
@@ -26,6 +26,8 @@
 #include "windowmanager.h"
 #include "blurhelper.h"
 #include "shortcuthandler.h"
+#include "bgndimageloader.h"
+#include "widgetclass.h"
 #include "pixmaps.h"
 #include <iostream>
 #include "config_file.h"
@@ -247,6 +249,13 @@ static enum
 
 static QString appName;
 
+static WidgetClassCache theWidgetClasses;
+
+static inline bool isClass(const QObject *o, WidgetClass c)
+{
+    return theWidgetClasses.is(o, c);
+}
+
 static inline bool isOOWidget(const QWidget *widget)
 {
     return APP_OPENOFFICE==theThemedApp && !widget;
@@ -424,9 +433,9 @@ static bool isInQAbstractItemView(const QObject *w)
 
     while(w && --level>0)
     {
-        if(qobject_cast<const QAbstractItemView *>(w))
+        if(isClass(w, WC_ITEM_VIEW))
             return true;
-        if(qobject_cast<const QDialog *>(w)/* || qobject_cast<const QMainWindow *>(w)*/)
+        if(isClass(w, WC_DIALOG)/* || isClass(w, WC_MAIN_WINDOW)*/)
             return false;
         w=w->parent();
     }
@@ -437,13 +446,13 @@ static bool isInQAbstractItemView(const QObject *w)
 static bool isKontactPreviewPane(const QWidget *widget)
 {
     return APP_KONTACT==theThemedApp && widget && widget->parentWidget() && widget->parentWidget()->parentWidget() &&
-           widget->inherits("KHBox") && ::qobject_cast<const QSplitter *>(widget->parentWidget()) &&
-           widget->parentWidget()->parentWidget()->inherits("KMReaderWin");
+           isClass(widget, WC_KHBOX) && ::qobject_cast<const QSplitter *>(widget->parentWidget()) &&
+           isClass(widget->parentWidget()->parentWidget(), WC_KMREADER_WIN);
 }
 
 static bool isKateView(const QWidget *widget)
 {
-    return widget && widget->parentWidget() && ::qobject_cast<const QFrame *>(widget) && widget->parentWidget()->inherits("KateView");
+    return widget && widget->parentWidget() && ::qobject_cast<const QFrame *>(widget) && isClass(widget->parentWidget(), WC_KATE_VIEW);
 }
 
 static bool isNoEtchWidget(const QWidget *widget)
@@ -455,10 +464,10 @@ static bool isNoEtchWidget(const QWidget *widget)
     {
         const QWidget *top=widget->window();
 
-        return !top || (!qobject_cast<const QDialog *>(top) && !qobject_cast<const QMainWindow *>(top));
+        return !top || (!isClass(top, WC_DIALOG) && !isClass(top, WC_MAIN_WINDOW));
     }
 
-    if(widget && widget->inherits("QWebView"))
+    if(widget && isClass(widget, WC_QWEBVIEW))
         return true;
 
     // KHTML:  widget -> QWidget       -> QWidget    -> KHTMLView
@@ -518,6 +527,24 @@ static void addStripes(QPainter *p, const QPainterPath &path, const QRect &rect,
     }
 }
 
+// Position of the busy indicator's chunk, within the bar's contents, for the given animation step
+static QRect busyChunkRect(const QRect &r, bool vertical, int step)
+{
+    int chunkSize(PROGRESS_CHUNK_WIDTH*3.4),
+        measure(vertical ? r.height() : r.width());
+
+    if(chunkSize>(measure/2))
+        chunkSize=measure/2;
+
+    int range(measure-chunkSize);
+
+    step=range>0 ? step % (range * 2) : 0;
+    if (step > range)
+        step = 2 * range - step;
+
+    return vertical ? QRect(r.x(), r.y()+step, r.width(), chunkSize) : QRect(r.x()+step, r.y(), chunkSize, r.height());
+}
+
 static QRegion windowMask(const QRect &r, bool full)
 {
     int x, y, w, h;
@@ -554,6 +581,12 @@ enum WindowsStyleConsts
 static const int constWindowMargin   =  2;
 static const int constProgressBarFps = 20;
 static const int constTabPad         =  6;
+#ifdef QTC_ENABLE_SHARED_TILE_CACHE
+// Misses are mostly served from the shared cache - which is just a copy, not a render - so keep less privately.
+static const int constPixmapCacheSize = 1*1024*1024; // bytes
+#else
+static const int constPixmapCacheSize = 4*1024*1024; // bytes
+#endif
 
 static const QLatin1String constDwtClose("qt_dockwidget_closebutton");
 static const QLatin1String constDwtFloat("qt_dockwidget_floatbutton");
@@ -828,7 +861,7 @@ static bool isOnToolbar(const QWidget *widget)
 
     while(wid)
     {
-        if(qobject_cast<const QToolBar *>(wid) || wid->inherits("Q3ToolBar"))
+        if(isClass(wid, WC_TOOLBAR))
             return true;
         wid=wid->parentWidget();
     }
@@ -839,19 +872,21 @@ static bool isOnToolbar(const QWidget *widget)
 #define PIXMAP_DIMENSION 10
 
 /*
-Cache key:
-    widgettype 2
-    app        5
-    size      15
-    horiz      1
-    alpha      8
-    blue       8
-    green      8
-    red        8
-    type       1  (0 for widget, 1 for pixmap)
-    ------------
-              56
+Cache keys are 128 bits - the top byte of 'high' holds the key type, the remaining bits are packed
+as per each createKey() below. 'low' usually holds the colour (alpha, red, green, blue).
 */
+enum EKeyType
+{
+    KEY_GRADIENT,
+    KEY_PIXMAP,
+    KEY_LIGHT_BEVEL,
+    KEY_STRIPES,
+    KEY_BGND,
+    KEY_BGND_SHINE,
+    KEY_SELECTION,
+    KEY_GRADIENT_RAMP
+};
+
 enum ECacheType
 {
     CACHE_STD,
@@ -860,6 +895,18 @@ enum ECacheType
     CACHE_TAB_BOT
 };
 
+static inline qulonglong keyType(EKeyType type)
+{
+    return ((qulonglong)type)<<56;
+}
+
+/*
+Gradient:
+    size      16
+    horiz      1
+    app        6
+    widgettype 2
+*/
 static QtcKey createKey(qulonglong size, const QColor &color, bool horiz, int app, EWidget w)
 {
     ECacheType type=WIDGET_TAB_TOP==w
@@ -870,19 +917,93 @@ static QtcKey createKey(qulonglong size, const QColor &color, bool horiz, int ap
                                 ? CACHE_PBAR
                                 : CACHE_STD;
 
-    return (color.rgba()<<1)+
-           (((qulonglong)(horiz ? 1 : 0))<<33)+
-           (((qulonglong)(size&0xFFFF))<<34)+
-           (((qulonglong)(app&0x1F))<<50)+
-           (((qulonglong)(type&0x03))<<55);
+    return QtcKey(keyType(KEY_GRADIENT)+
+                  (size&0xFFFF)+
+                  (((qulonglong)(horiz ? 1 : 0))<<16)+
+                  (((qulonglong)(app&0x3F))<<17)+
+                  (((qulonglong)(type&0x03))<<23),
+                  color.rgba());
 }
 
 static QtcKey createKey(const QColor &color, EPixmap p)
 {
-    return 1+
-           ((color.rgb()&RGB_MASK)<<1)+
-           (((qulonglong)(p&0x1F))<<33)+
-           (((qulonglong)1)<<38);
+    return QtcKey(keyType(KEY_PIXMAP)+(p&0x1F), color.rgba());
+}
+
+/*
+Light bevel:
+    widget     6
+    toolbar    1
+    round      4
+    realRound  3
+    state     17
+    radius    16
+  low:
+    colour    32
+    width     16
+    height    16
+*/
+static QtcKey createBevelKey(EWidget w, bool onToolbar, int round, ERound realRound, const QSize &size, uint state,
+                             const QColor &fill, double radius)
+{
+    return QtcKey(keyType(KEY_LIGHT_BEVEL)+
+                  (w&0x3F)+
+                  (((qulonglong)(onToolbar ? 1 : 0))<<6)+
+                  (((qulonglong)(round&0x0F))<<7)+
+                  (((qulonglong)(realRound&0x07))<<11)+
+                  (((qulonglong)(state&0x1FFFF))<<14)+
+                  (((qulonglong)(((int)(radius*100))&0xFFFF))<<31),
+                  fill.rgba()+
+                  (((qulonglong)(size.width()&0xFFFF))<<32)+
+                  (((qulonglong)(size.height()&0xFFFF))<<48));
+}
+
+static QtcKey createStripesKey(const QColor &color)
+{
+    return QtcKey(keyType(KEY_STRIPES), color.rgba());
+}
+
+static QtcKey createBgndKey(const QColor &color, EGradType grad, EAppearance app, int length)
+{
+    return QtcKey(keyType(KEY_BGND)+(app&0xFF)+(((qulonglong)(grad&0xFF))<<8)+(((qulonglong)(length&0xFFFF))<<16),
+                  color.rgba());
+}
+
+static QtcKey createShineKey(const QColor &color, int size)
+{
+    return QtcKey(keyType(KEY_BGND_SHINE)+(size&0xFFFF), color.rgba());
+}
+
+/*
+Gradient ramp:
+    length    16
+    app        8
+    flags      8
+  low:
+    colour    32
+    titlebar  32 (background colour, only used for titlebar blending)
+*/
+enum ERampFlags
+{
+    RAMP_HORIZ    = 0x01,
+    RAMP_SEL      = 0x02,
+    RAMP_TOP_TAB  = 0x04,
+    RAMP_BOT_TAB  = 0x08,
+    RAMP_DWT      = 0x10,
+    RAMP_TITLEBAR = 0x20,
+    RAMP_REVERSE  = 0x40,
+    RAMP_TOOLTIP  = 0x80
+};
+
+static QtcKey createRampKey(const QColor &color, EAppearance app, int flags, int length, const QColor &titlebar)
+{
+    return QtcKey(keyType(KEY_GRADIENT_RAMP)+(length&0xFFFF)+(((qulonglong)(app&0xFF))<<16)+(((qulonglong)(flags&0xFF))<<24),
+                  color.rgba()+(flags&RAMP_TITLEBAR ? ((qulonglong)titlebar.rgba())<<32 : 0));
+}
+
+static QtcKey createSelectionKey(const QColor &color, int height, double radius)
+{
+    return QtcKey(keyType(KEY_SELECTION)+(height&0xFFFF)+(((qulonglong)(((int)(radius*100))&0xFFFF))<<16), color.rgba());
 }
 
 #if !defined QTC_QT_ONLY
@@ -950,9 +1071,9 @@ inline bool isMultiTabBarTab(const QAbstractButton *button)
 {
     // Check for isFlat fails in KDE SC4.5
     return button && ( (::qobject_cast<const QPushButton *>(button) && // ((QPushButton *)button)->isFlat() &&
-                            button->inherits("KMultiTabBarTab")) ||
+                            isClass(button, WC_KMULTITABBAR_TAB)) ||
                        (APP_KDEVELOP==theThemedApp && ::qobject_cast<const QToolButton *>(button) &&
-                            button->inherits("Sublime::IdealToolButton")) );
+                            isClass(button, WC_KDEV_IDEAL_BUTTON)) );
 }
 
 #ifdef QTC_STYLE_SUPPORT
@@ -969,13 +1090,12 @@ Style::Style()
         itsOOMenuCols(0L),
         itsProgressCols(0L),
         itsSaveMenuBarStatus(false),
-        itsUsePixmapCache(true),
         itsInactiveChangeSelectionColor(false),
         itsIsPreview(PREVIEW_FALSE),
         itsSidebarButtonsCols(0L),
         itsActiveMdiColors(0L),
         itsMdiColors(0L),
-        itsPixmapCache(150000),
+        itsPixmapCache(constPixmapCacheSize),
         itsActive(true),
         itsSbWidget(0L),
         itsClickedLabel(0L),
@@ -991,25 +1111,29 @@ Style::Style()
         itsSViewSBar(0L),
         itsWindowManager(new WindowManager(this)),
         itsBlurHelper(new BlurHelper(this)),
-        itsShortcutHandler(new ShortcutHandler(this))
+        itsShortcutHandler(new ShortcutHandler(this)),
+        itsBgndImageLoader(new BgndImageLoader(this))
 #ifdef QTC_STYLE_SUPPORT
         , itsName(name)
 #endif
 {
+    // Until init() has worked out which event types are needed, filter them all...
+    for(int i=0; i<constNumFilterEvents; ++i)
+        itsFilterEvents[i]=true;
+    memset(itsFilterCounts, 0, sizeof(itsFilterCounts));
+
     const char *env=getenv(QTCURVE_PREVIEW_CONFIG);
     if(env && 0==strcmp(env, QTCURVE_PREVIEW_CONFIG))
     {
         // To enable preview of QtCurve settings, the style config module will set QTCURVE_PREVIEW_CONFIG
-        // and use CE_QtC_SetOptions to set options. If this is set, we do not use the QPixmapCache as it
-        // will interfere with that of the kcm's widgets!
+        // and use CE_QtC_SetOptions to set options. Our pixmap cache is private to this style instance, so
+        // it does not interfere with that of the kcm's widgets.
         itsIsPreview=PREVIEW_MDI;
-        itsUsePixmapCache=false;
     }
     else if(env && 0==strcmp(env, QTCURVE_PREVIEW_CONFIG_FULL))
     {
         // As above, but preview is in window - so can use opacity settings!
         itsIsPreview=PREVIEW_WINDOW;
-        itsUsePixmapCache=false;
     }
     else
         init(true);
@@ -1018,7 +1142,17 @@ Style::Style()
 void Style::init(bool initial)
 {
     if(!initial)
+    {
         freeColors();
+        // Settings may have changed, so any cached gradients/pixmaps/shades are no longer valid...
+        itsPixmapCache.clear();
+        itsShadeCache.clear();
+        theWidgetClasses.clear();
+    }
+
+    // Any background images still loading are for the old settings - this includes init(true) from the config
+    // dialog's preview, which re-uses the same QtCImage structures.
+    itsBgndImageLoader->cancel();
 
 #if !defined QTC_QT_ONLY
     if(initial)
@@ -1061,8 +1195,14 @@ void Style::init(bool initial)
             }
         }
         qtcReadConfig(rcFile, &opts);
+#if defined QTC_ENABLE_DISK_TILE_CACHE || defined QTC_ENABLE_SHARED_TILE_CACHE
+        itsConfigFile=rcFile.isEmpty() ? qtcConfigFile() : rcFile;
+#endif
 #else
         qtcReadConfig(QString(), &opts);
+#if defined QTC_ENABLE_DISK_TILE_CACHE || defined QTC_ENABLE_SHARED_TILE_CACHE
+        itsConfigFile=qtcConfigFile();
+#endif
 #endif
 
 #ifdef Q_WS_X11
@@ -1340,6 +1480,17 @@ void Style::init(bool initial)
         qtcCalcRingAlphas(&itsBackgroundCols[ORIGINAL_SHADE]);
 
     itsBlurHelper->setEnabled(100!=opts.bgndOpacity || 100!=opts.dlgOpacity || 100!=opts.menuBgndOpacity);
+    setupEventFilterTypes();
+
+    // Start loading any background images now, so that they are (hopefully) ready by the time the first window is shown.
+    itsBgndImageLoader->load(&opts.bgndImage);
+    itsBgndImageLoader->load(&opts.menuBgndImage);
+
+#if defined QTC_ENABLE_DISK_TILE_CACHE || defined QTC_ENABLE_SHARED_TILE_CACHE
+    // On the initial call, the tile caches are opened once the application's palette is known - see polish(QPalette &)
+    if(!initial)
+        openTileCaches(QApplication::palette());
+#endif
 
 #if !defined QTC_QT_ONLY
     // Ensure the link to libkio is not stripped, by placing a call to a kio function.
@@ -1357,6 +1508,17 @@ void Style::init(bool initial)
 
 Style::~Style()
 {
+    if(NULL!=getenv("QTCURVE_DEBUG"))
+        for(int i=0; i<=constNumFilterEvents; ++i)
+            if(itsFilterCounts[i])
+            {
+                if(i<constNumFilterEvents)
+                    std::cout << "QtCurve: Filtered events of type " << i << ": " << itsFilterCounts[i]
+                              << (itsFilterEvents[i] ? "\n" : " (ignored)\n");
+                else
+                    std::cout << "QtCurve: Filtered events of other types: " << itsFilterCounts[i] << " (ignored)\n";
+            }
+
     freeColors();
 #ifdef Q_WS_X11
     if(itsDBus)
@@ -1372,10 +1534,7 @@ void Style::freeColor(QSet<QColor *> &freedColors, QColor **cols)
         *cols!=itsMenubarCols &&
         *cols!=itsFocusCols &&
         *cols!=itsMouseOverCols &&
-        *cols!=itsButtonCols &&
-        *cols!=itsColoredButtonCols &&
-        *cols!=itsColoredBackgroundCols &&
-        *cols!=itsColoredHighlightCols)
+        *cols!=itsButtonCols)
     {
         freedColors.insert(*cols);
         delete [] *cols;
@@ -1386,7 +1545,10 @@ void Style::freeColor(QSet<QColor *> &freedColors, QColor **cols)
 void Style::freeColors()
 {
     if(0!=itsProgressBarAnimateTimer)
+    {
         killTimer(itsProgressBarAnimateTimer);
+        itsProgressBarAnimateTimer=0;
+    }
 
     QSet<QColor *> freedColors;
 
@@ -1529,6 +1691,8 @@ void Style::polish(QApplication *app)
     }
 #endif
 
+    // The above may have changed the settings that eventFilter() depends upon...
+    setupEventFilterTypes();
     BASE_STYLE::polish(app);
     if(opts.hideShortcutUnderline)
         Utils::addEventFilter(app, itsShortcutHandler);
@@ -1584,8 +1748,7 @@ void Style::polish(QPalette &palette)
            IMG_SQUARE_RINGS==opts.menuBgndImage.type)
         {
             qtcCalcRingAlphas(&itsBackgroundCols[ORIGINAL_SHADE]);
-            if(itsUsePixmapCache)
-                QPixmapCache::clear();
+            itsPixmapCache.clear();
         }
     }
 
@@ -1699,7 +1862,68 @@ void Style::polish(QPalette &palette)
     if(kapp)
         setDecorationColors();
 #endif
+#if defined QTC_ENABLE_DISK_TILE_CACHE || defined QTC_ENABLE_SHARED_TILE_CACHE
+    openTileCaches(palette);
+#endif
+}
+
+#if defined QTC_ENABLE_DISK_TILE_CACHE || defined QTC_ENABLE_SHARED_TILE_CACHE
+static void addFileToHash(QCryptographicHash &hash, const QString &file)
+{
+    QFileInfo info(file);
+
+    hash.addData(QFile::encodeName(file));
+    if(info.exists())
+    {
+        uint modified(info.lastModified().toTime_t());
+        hash.addData((const char *)&modified, sizeof(modified));
+    }
+}
+
+// Tiles in the disk and shared caches are only valid for the exact settings and palette they were rendered with.
+// Therefore, these caches are named by a hash of these - the config file contents, any images it references, the
+// palette, and the settings that are altered per-application in polish(QApplication *).
+void Style::openTileCaches(const QPalette &palette)
+{
+    if(itsIsPreview)
+        return;
+
+    QCryptographicHash hash(QCryptographicHash::Md5);
+    QFile              cfg(itsConfigFile);
+
+    hash.addData(VERSION);
+    addFileToHash(hash, itsConfigFile);
+    if(cfg.open(QIODevice::ReadOnly))
+        hash.addData(cfg.readAll());
+    if(APPEARANCE_FILE==opts.bgndAppearance)
+        addFileToHash(hash, opts.bgndPixmap.file);
+    if(APPEARANCE_FILE==opts.menuBgndAppearance)
+        addFileToHash(hash, opts.menuBgndPixmap.file);
+
+    int appOpts[]={ theThemedApp, opts.contrast, opts.forceAlternateLvCols, opts.bgndAppearance, opts.bgndImage.type,
+                    opts.menuStripe, opts.bgndOpacity, opts.dlgOpacity, opts.menuBgndOpacity, opts.scrollbarType,
+                    opts.menuitemAppearance, opts.borderMenuitems, opts.etchEntry, opts.lighterPopupMenuBgnd,
+                    opts.menuBgndAppearance };
+
+    hash.addData((const char *)appOpts, sizeof(appOpts));
+
+    for(int g=0; g<QPalette::NColorGroups; ++g)
+        for(int r=0; r<QPalette::NColorRoles; ++r)
+        {
+            QRgb rgb(palette.color((QPalette::ColorGroup)g, (QPalette::ColorRole)r).rgba());
+            hash.addData((const char *)&rgb, sizeof(rgb));
+        }
+
+    QString name(QString::fromLatin1(hash.result().toHex()));
+
+#ifdef QTC_ENABLE_SHARED_TILE_CACHE
+    itsPixmapCache.openSharedCache(name);
+#endif
+#ifdef QTC_ENABLE_DISK_TILE_CACHE
+    itsPixmapCache.openDiskCache(QFile::decodeName(qtcConfDir())+QLatin1String("cache/tiles-")+name+QLatin1String(".bin"));
+#endif
 }
+#endif
 
 static inline void setTranslucentBackground(QWidget *widget)
 {
@@ -1783,7 +2007,7 @@ void Style::polish(QWidget *widget)
                 because it conflicts with some widgets embedded into the SysTray. Ideally one would
                 rather find a "generic" reason, not to handle them
                 */
-                if(APP_PLASMA==theThemedApp && !widget->inherits("QDialog"))
+                if(APP_PLASMA==theThemedApp && !isClass(widget, WC_DIALOG))
                     break;
 
 #ifdef Q_WS_X11
@@ -1793,7 +2017,7 @@ void Style::polish(QWidget *widget)
 
 #ifdef Q_WS_X11
                 if(APP_KONSOLE==theThemedApp && 100!=opacity && widget->testAttribute(Qt::WA_TranslucentBackground) &&
-                   widget->inherits("Konsole::MainWindow"))
+                   isClass(widget, WC_KONSOLE_MAIN_WINDOW))
                 {
                     // Background translucency does not work for konsole :-(
                     // So, just set titlebar opacity...
@@ -1804,8 +2028,8 @@ void Style::polish(QWidget *widget)
 #endif
                 if(100==opacity || !widget->isWindow() || Qt::Desktop==widget->windowType() || widget->testAttribute(Qt::WA_X11NetWmWindowTypeDesktop) ||
                    widget->testAttribute(Qt::WA_TranslucentBackground) || widget->testAttribute(Qt::WA_NoSystemBackground) ||
-                   widget->testAttribute(Qt::WA_PaintOnScreen) || widget->inherits("KScreenSaver") || widget->inherits( "QTipLabel") ||
-                   widget->inherits( "QSplashScreen") || widget->windowFlags().testFlag(Qt::FramelessWindowHint) ||
+                   widget->testAttribute(Qt::WA_PaintOnScreen) || isClass(widget, WC_KSCREENSAVER) || isClass(widget, WC_TIP_LABEL) ||
+                   isClass(widget, WC_SPLASH_SCREEN) || widget->windowFlags().testFlag(Qt::FramelessWindowHint) ||
                    !(widget->testAttribute(Qt::WA_WState_Created) || widget->internalWinId()))
                     break;
 
@@ -1854,7 +2078,7 @@ void Style::polish(QWidget *widget)
             widget->parentWidget()->parentWidget() && //grampa
             qobject_cast<QAbstractScrollArea*>(widget->parentWidget()->parentWidget()) &&
             widget->parentWidget()->parentWidget()->parentWidget() && // grangrampa
-            widget->parentWidget()->parentWidget()->parentWidget()->inherits("QToolBox"))
+            isClass(widget->parentWidget()->parentWidget()->parentWidget(), WC_TOOLBOX))
         {
             widget->parentWidget()->setAutoFillBackground(false);
             widget->setAutoFillBackground(false);
@@ -1911,9 +2135,9 @@ void Style::polish(QWidget *widget)
         if(opts.forceAlternateLvCols &&
            viewport->autoFillBackground() && // Dolphins Folders panel
            //255==viewport->palette().color(itemView->viewport()->backgroundRole()).alpha() && // KFilePlacesView
-           !widget->inherits("KFilePlacesView") &&
+           !isClass(widget, WC_KFILE_PLACES_VIEW) &&
            // Exclude non-editable combo popup...
-           !(opts.gtkComboMenus && widget->inherits("QComboBoxListView") && widget->parentWidget() && widget->parentWidget()->parentWidget() &&
+           !(opts.gtkComboMenus && isClass(widget, WC_COMBO_LIST_VIEW) && widget->parentWidget() && widget->parentWidget()->parentWidget() &&
              qobject_cast<QComboBox *>(widget->parentWidget()->parentWidget()) &&
              !static_cast<QComboBox *>(widget->parentWidget()->parentWidget())->isEditable()) &&
            // Exclude KAboutDialog...
@@ -1929,27 +2153,7 @@ void Style::polish(QWidget *widget)
     if(APP_KONTACT==theThemedApp && qobject_cast<QToolButton *>(widget))
         ((QToolButton *)widget)->setAutoRaise(true);
 
-    if(enableMouseOver &&
-       (qobject_cast<QPushButton *>(widget) ||
-        qobject_cast<QAbstractButton*>(widget) ||
-        qobject_cast<QComboBox *>(widget) ||
-        qobject_cast<QAbstractSpinBox *>(widget) ||
-        qobject_cast<QCheckBox *>(widget) ||
-        qobject_cast<QGroupBox *>(widget) ||
-        qobject_cast<QRadioButton *>(widget) ||
-        qobject_cast<QSplitterHandle *>(widget) ||
-        qobject_cast<QSlider *>(widget) ||
-        qobject_cast<QHeaderView *>(widget) ||
-        qobject_cast<QTabBar *>(widget) ||
-        qobject_cast<QAbstractScrollArea *>(widget) ||
-        qobject_cast<QTextEdit *>(widget) ||
-        qobject_cast<QLineEdit *>(widget) ||
-        qobject_cast<QDial *>(widget) ||
-//        qobject_cast<QDockWidget *>(widget) ||
-        widget->inherits("QWorkspaceTitleBar") ||
-        widget->inherits("QDockSeparator") ||
-        widget->inherits("QDockWidgetSeparator") ||
-        widget->inherits("Q3DockWindowResizeHandle")))
+    if(enableMouseOver && isClass(widget, WC_HOVER))
         widget->setAttribute(Qt::WA_Hover, true);
 
     if (qobject_cast<QSplitterHandle *>(widget))
@@ -1962,7 +2166,7 @@ void Style::polish(QWidget *widget)
         if(!opts.gtkScrollViews)
             Utils::addEventFilter(widget, this);
     }
-    else if (qobject_cast<QAbstractScrollArea *>(widget) && widget->inherits("KFilePlacesView"))
+    else if (qobject_cast<QAbstractScrollArea *>(widget) && isClass(widget, WC_KFILE_PLACES_VIEW))
     {
         if(CUSTOM_BGND)
             polishScrollArea(static_cast<QAbstractScrollArea *>(widget), true);
@@ -1981,12 +2185,12 @@ void Style::polish(QWidget *widget)
             setBold(widget);
         Utils::addEventFilter(widget, this);
     }
-    else if (widget->inherits("Q3Header"))
+    else if (isClass(widget, WC_Q3_HEADER))
     {
         widget->setMouseTracking(true);
         Utils::addEventFilter(widget, this);
     }
-    else if(opts.highlightScrollViews && widget->inherits("Q3ScrollView"))
+    else if(opts.highlightScrollViews && isClass(widget, WC_Q3_SCROLLVIEW))
     {
         Utils::addEventFilter(widget, this);
         widget->setAttribute(Qt::WA_Hover, true);
@@ -1995,7 +2199,7 @@ void Style::polish(QWidget *widget)
     {
 #ifdef Q_WS_X11
         if (opts.xbar &&
-            (!((APP_QTDESIGNER==theThemedApp || APP_KDEVELOP==theThemedApp) && widget->inherits("QDesignerMenuBar"))))
+            (!((APP_QTDESIGNER==theThemedApp || APP_KDEVELOP==theThemedApp) && isClass(widget, WC_DESIGNER_MENUBAR))))
             Bespin::MacMenu::manage((QMenuBar *)widget);
 
         if(BLEND_TITLEBAR || opts.menubarHiding&HIDE_KWIN || opts.windowBorder&WINDOW_BORDER_USE_MENUBAR_COLOR_FOR_TITLEBAR)
@@ -2018,7 +2222,7 @@ void Style::polish(QWidget *widget)
            ((QLabel *)widget)->textInteractionFlags().testFlag(Qt::TextSelectableByMouse) &&
            widget->parentWidget() && widget->parentWidget()->parentWidget() && ::qobject_cast<QFrame *>(widget->parentWidget()) &&
 #ifdef QTC_QT_ONLY
-           widget->parentWidget()->parentWidget()->inherits("KTitleWidget")
+           isClass(widget->parentWidget()->parentWidget(), WC_KTITLE_WIDGET)
 #else
             ::qobject_cast<KTitleWidget *>(widget->parentWidget()->parentWidget())
 #endif
@@ -2045,14 +2249,14 @@ void Style::polish(QWidget *widget)
             }
         }
     }
-    else if(qobject_cast<QDialog*>(widget) && widget->inherits("QPrintPropertiesDialog") &&
+    else if(qobject_cast<QDialog*>(widget) && isClass(widget, WC_PRINT_PROPERTIES_DIALOG) &&
             widget->parentWidget() && widget->parentWidget()->topLevelWidget() &&
             widget->topLevelWidget() && widget->topLevelWidget()->windowTitle().isEmpty() &&
             !widget->parentWidget()->topLevelWidget()->windowTitle().isEmpty())
     {
         widget->topLevelWidget()->setWindowTitle(widget->parentWidget()->topLevelWidget()->windowTitle());
     }
-    else if(widget->inherits("QWhatsThat"))
+    else if(isClass(widget, WC_WHATS_THAT))
     {
         QPalette pal(widget->palette());
         QColor   shadow(pal.shadow().color());
@@ -2067,7 +2271,7 @@ void Style::polish(QWidget *widget)
             widget->parentWidget()->parentWidget() &&
             widget->parentWidget()->parentWidget()->parentWidget() &&
             qobject_cast<QSplitter *>(widget->parentWidget()) &&
-            widget->parentWidget()->parentWidget()->inherits("KFileWidget") /*&&
+            isClass(widget->parentWidget()->parentWidget(), WC_KFILE_WIDGET) /*&&
             widget->parentWidget()->parentWidget()->parentWidget()->inherits("KFileDialog")*/)
         ((QDockWidget *)widget)->setTitleBarWidget(new QtCurveDockWidgetTitleBar(widget));
 #ifdef QTC_ENABLE_PARENTLESS_DIALOG_FIX_SUPPORT
@@ -2085,10 +2289,10 @@ void Style::polish(QWidget *widget)
     }
 #endif
     else if((!IS_FLAT_BGND(opts.menuBgndAppearance) || 100!=opts.menuBgndOpacity || !(opts.square&SQUARE_POPUP_MENUS)) &&
-             widget->inherits("QComboBoxPrivateContainer") && !widget->testAttribute(Qt::WA_TranslucentBackground))
+             isClass(widget, WC_COMBO_CONTAINER) && !widget->testAttribute(Qt::WA_TranslucentBackground))
         setTranslucentBackground(widget);
 
-    if(widget->inherits("QTipLabel") && !IS_FLAT(opts.tooltipAppearance) && APP_OPERA!=theThemedApp)
+    if(isClass(widget, WC_TIP_LABEL) && !IS_FLAT(opts.tooltipAppearance) && APP_OPERA!=theThemedApp)
     {
         widget->setBackgroundRole(QPalette::NoRole);
         setTranslucentBackground(widget);
@@ -2104,7 +2308,7 @@ void Style::polish(QWidget *widget)
                  Utils::addEventFilter(widget, this);
 
 #ifdef QTC_QT_ONLY
-            if(widget->parent() && widget->parent()->inherits("KTitleWidget"))
+            if(widget->parent() && isClass(widget->parent(), WC_KTITLE_WIDGET))
 #else
             if(widget->parent() && qobject_cast<KTitleWidget *>(widget->parent()))
 #endif
@@ -2141,7 +2345,7 @@ void Style::polish(QWidget *widget)
 
     if(qobject_cast<QMenu *>(widget)/* && !(widget->parentWidget() &&
 #ifdef QTC_QT_ONLY
-        widget->inherits("KMenu") && widget->parentWidget()->inherits("KXmlGuiWindow")
+        isClass(widget, WC_KMENU) && isClass(widget->parentWidget(), WC_KXMLGUI_WINDOW)
 #else
         qobject_cast<KMenu *>(widget) && qobject_cast<KXmlGuiWindow *>(widget->parentWidget())
 #endif
@@ -2167,7 +2371,7 @@ void Style::polish(QWidget *widget)
     }
 
     if((!IS_FLAT_BGND(opts.menuBgndAppearance) || 100!=opts.menuBgndOpacity || !(opts.square&SQUARE_POPUP_MENUS)) &&
-        widget->inherits("QComboBoxPrivateContainer"))
+        isClass(widget, WC_COMBO_CONTAINER))
     {
         Utils::addEventFilter(widget, this);
         if((100!=opts.menuBgndOpacity || !(opts.square&SQUARE_POPUP_MENUS)) && !widget->testAttribute(Qt::WA_TranslucentBackground))
@@ -2188,7 +2392,7 @@ void Style::polish(QWidget *widget)
 
         while(wid && !parentIsToolbar)
         {
-            parentIsToolbar=qobject_cast<QToolBar *>(wid) || wid->inherits("Q3ToolBar");
+            parentIsToolbar=isClass(wid, WC_TOOLBAR);
             wid=wid->parentWidget();
         }
     }
@@ -2198,7 +2402,7 @@ void Style::polish(QWidget *widget)
 
     if(APP_QTCREATOR==theThemedApp && qobject_cast<QDialog *>(widget) &&
 #ifdef QTC_QT_ONLY
-        widget->inherits("KFileDialog")
+        isClass(widget, WC_KFILE_DIALOG)
 #else
         qobject_cast<KFileDialog *>(widget)
 #endif
@@ -2218,7 +2422,7 @@ void Style::polish(QWidget *widget)
     if(parentIsToolbar && (qobject_cast<QComboBox *>(widget) || qobject_cast<QLineEdit *>(widget)))
         widget->setFont(QApplication::font());
 
-    if (qobject_cast<QMenuBar *>(widget) || widget->inherits("Q3ToolBar") || qobject_cast<QToolBar *>(widget) || parentIsToolbar)
+    if (qobject_cast<QMenuBar *>(widget) || isClass(widget, WC_TOOLBAR) || parentIsToolbar)
         widget->setBackgroundRole(QPalette::Window);
 
     if(!IS_FLAT(opts.toolbarAppearance) && parentIsToolbar)
@@ -2243,14 +2447,14 @@ void Style::polish(QWidget *widget)
                 polishLayout(layout);
     }
 
-    if( (APP_K3B==theThemedApp && widget->inherits("K3b::ThemedHeader") && qobject_cast<QFrame *>(widget)) ||
-        widget->inherits("KColorPatch"))
+    if( (APP_K3B==theThemedApp && isClass(widget, WC_K3B_THEMED_HEADER) && qobject_cast<QFrame *>(widget)) ||
+        isClass(widget, WC_KCOLOR_PATCH))
     {
         ((QFrame *)widget)->setLineWidth(0);
         ((QFrame *)widget)->setFrameShape(QFrame::NoFrame);
     }
 
-    if(APP_KDEVELOP==theThemedApp && !opts.stdSidebarButtons && widget->inherits("Sublime::IdealButtonBarWidget") && widget->layout())
+    if(APP_KDEVELOP==theThemedApp && !opts.stdSidebarButtons && isClass(widget, WC_KDEV_IDEAL_BUTTON_BAR) && widget->layout())
     {
         widget->layout()->setSpacing(0);
         widget->layout()->setMargin(0);
@@ -2265,7 +2469,7 @@ void Style::polish(QWidget *widget)
         widget->removeEventFilter(this);
         Utils::addEventFilter(widget, this);
 
-        if(widget->inherits("KFilePlacesView"))
+        if(isClass(widget, WC_KFILE_PLACES_VIEW))
         {
             widget->setAutoFillBackground(false);
             widget->setAttribute(Qt::WA_OpaquePaintEvent, false);
@@ -2338,7 +2542,7 @@ void Style::polishFormLayout(QFormLayout *layout)
         int fieldHeight = fieldItem->sizeHint().height();
 #if QT_VERSION < 0x040600
         // work around KIntNumInput::sizeHint() bug
-        if (fieldItem->widget() && fieldItem->widget()->inherits("KIntNumInput"))
+        if (fieldItem->widget() && isClass(fieldItem->widget(), WC_KINTNUMINPUT))
         {
             fieldHeight -= 2;
             fieldItem->widget()->setMaximumHeight(fieldHeight);
@@ -2387,7 +2591,7 @@ void Style::polishScrollArea(QAbstractScrollArea *scrollArea, bool isKFilePlaces
 
     // HACK: add exception for KPIM transactionItemView, which is an overlay widget and must have filled background. This is a temporary workaround
     // until a more robust solution is found.
-    if(scrollArea->inherits("KPIM::TransactionItemView"))
+    if(isClass(scrollArea, WC_KPIM_TRANSACTION_VIEW))
     {
         // also need to make the scrollarea background plain (using autofill background) so that optional vertical scrollbar background is not
         // transparent either.
@@ -2420,6 +2624,7 @@ void Style::unpolish(QApplication *app)
 {
     if(opts.hideShortcutUnderline)
         app->removeEventFilter(itsShortcutHandler);
+    theWidgetClasses.clear();
     BASE_STYLE::unpolish(app);
 }
 
@@ -2524,12 +2729,12 @@ void Style::unpolish(QWidget *widget)
             unSetBold(widget);
         itsProgressBars.remove((QProgressBar *)widget);
     }
-    else if (widget->inherits("Q3Header"))
+    else if (isClass(widget, WC_Q3_HEADER))
     {
         widget->setMouseTracking(false);
         widget->removeEventFilter(this);
     }
-    else if(opts.highlightScrollViews && widget->inherits("Q3ScrollView"))
+    else if(opts.highlightScrollViews && isClass(widget, WC_Q3_SCROLLVIEW))
         widget->removeEventFilter(this);
     else if(qobject_cast<QMenuBar *>(widget))
     {
@@ -2582,7 +2787,7 @@ void Style::unpolish(QWidget *widget)
             widget->parentWidget()->parentWidget() &&
             widget->parentWidget()->parentWidget()->parentWidget() &&
             qobject_cast<QSplitter *>(widget->parentWidget()) &&
-            widget->parentWidget()->parentWidget()->inherits("KFileWidget") /*&&
+            isClass(widget->parentWidget()->parentWidget(), WC_KFILE_WIDGET) /*&&
             widget->parentWidget()->parentWidget()->parentWidget()->inherits("KFileDialog")*/)
     {
         delete ((QDockWidget *)widget)->titleBarWidget();
@@ -2595,7 +2800,7 @@ void Style::unpolish(QWidget *widget)
     else if(opts.boldProgress && "CE_CapacityBar"==widget->objectName())
         unSetBold(widget);
 
-    if(widget->inherits("QTipLabel") && !IS_FLAT(opts.tooltipAppearance) && APP_OPERA!=theThemedApp)
+    if(isClass(widget, WC_TIP_LABEL) && !IS_FLAT(opts.tooltipAppearance) && APP_OPERA!=theThemedApp)
     {
         widget->setAttribute(Qt::WA_PaintOnScreen, false);
         widget->setAttribute(Qt::WA_NoSystemBackground, false);
@@ -2609,7 +2814,7 @@ void Style::unpolish(QWidget *widget)
                  widget->removeEventFilter(this);
 
 #ifdef QTC_QT_ONLY
-            if(widget->parent() && widget->parent()->inherits("KTitleWidget"))
+            if(widget->parent() && isClass(widget->parent(), WC_KTITLE_WIDGET))
 #else
             if(widget->parent() && qobject_cast<KTitleWidget *>(widget->parent()))
 #endif
@@ -2645,7 +2850,7 @@ void Style::unpolish(QWidget *widget)
     }
 
     if((!IS_FLAT_BGND(opts.menuBgndAppearance) || 100!=opts.menuBgndOpacity || !(opts.square&SQUARE_POPUP_MENUS)) &&
-        widget->inherits("QComboBoxPrivateContainer"))
+        isClass(widget, WC_COMBO_CONTAINER))
     {
         widget->removeEventFilter(this);
         widget->setAttribute(Qt::WA_PaintOnScreen, false);
@@ -2655,8 +2860,7 @@ void Style::unpolish(QWidget *widget)
     }
 
     if (qobject_cast<QMenuBar *>(widget) ||
-        widget->inherits("Q3ToolBar") ||
-        qobject_cast<QToolBar *>(widget) ||
+        isClass(widget, WC_TOOLBAR) ||
         (widget && qobject_cast<QToolBar *>(widget->parent())))
         widget->setBackgroundRole(QPalette::Button);
 #ifdef Q_WS_X11
@@ -2703,17 +2907,86 @@ static bool updateMenuBarEvent(QMouseEvent *event, QMenuBar *menu)
     return false;
 }
 
+// Works out which event types eventFilter() needs to look at with the current settings, so that it can ignore all
+// others without doing any casts. Must be kept in step with eventFilter()!
+void Style::setupEventFilterTypes()
+{
+    static const QEvent::Type constAlways[]=
+    {
+        QEvent::MouseMove, QEvent::MouseButtonPress, QEvent::MouseButtonRelease, QEvent::MouseButtonDblClick,
+        QEvent::NonClientAreaMouseMove, QEvent::NonClientAreaMouseButtonPress,
+        QEvent::NonClientAreaMouseButtonRelease, QEvent::NonClientAreaMouseButtonDblClick,
+        QEvent::Resize, QEvent::Paint, QEvent::Show, QEvent::StyleChange, QEvent::Hide, QEvent::Destroy,
+        QEvent::Enter, QEvent::Leave
+#ifdef Q_WS_X11
+        , QEvent::PaletteChange
+#endif
+    };
+
+    for(int i=0; i<constNumFilterEvents; ++i)
+        itsFilterEvents[i]=false;
+    for(unsigned int i=0; i<sizeof(constAlways)/sizeof(constAlways[0]); ++i)
+        itsFilterEvents[constAlways[i]]=true;
+
+    if(!opts.gtkScrollViews || APP_KONTACT==theThemedApp)
+        itsFilterEvents[QEvent::Wheel]=true;
+    if(opts.menubarHiding || opts.statusbarHiding)
+        itsFilterEvents[QEvent::ShortcutOverride]=itsFilterEvents[QEvent::ShowToParent]=true;
+    if(opts.highlightScrollViews)
+        itsFilterEvents[QEvent::FocusIn]=itsFilterEvents[QEvent::FocusOut]=true;
+    if(opts.shadeMenubarOnlyWhenActive && SHADE_NONE!=opts.shadeMenubars)
+        itsFilterEvents[QEvent::WindowActivate]=itsFilterEvents[QEvent::WindowDeactivate]=true;
+#ifdef QTC_ENABLE_PARENTLESS_DIALOG_FIX_SUPPORT
+    if(opts.fixParentlessDialogs)
+        itsFilterEvents[70]=true; // QEvent::ChildInserted - QT3_SUPPORT
+#endif
+}
+
 bool Style::eventFilter(QObject *object, QEvent *event)
 {
-    bool isSViewCont=APP_KONTACT==theThemedApp && itsSViewContainers.contains((QWidget*)object);
+    int type(event->type());
 
-    if(::qobject_cast<QMenuBar *>(object) && dynamic_cast<QMouseEvent *>(event))
+    // Most events are of no interest, so reject these before doing anything else...
+    if(type<0 || type>=constNumFilterEvents)
+    {
+        ++itsFilterCounts[constNumFilterEvents];
+        return BASE_STYLE::eventFilter(object, event);
+    }
+    ++itsFilterCounts[type];
+    if(!itsFilterEvents[type])
+        return BASE_STYLE::eventFilter(object, event);
+
+    bool mouseEvent(false), // Event is a QMouseEvent
+         sviewEvent(false); // Event may be passed on to a scrollview's scrollbars
+
+    switch(type)
+    {
+        case QEvent::MouseMove:
+        case QEvent::MouseButtonPress:
+        case QEvent::MouseButtonRelease:
+            sviewEvent=true;
+        case QEvent::MouseButtonDblClick:
+        case QEvent::NonClientAreaMouseMove:
+        case QEvent::NonClientAreaMouseButtonPress:
+        case QEvent::NonClientAreaMouseButtonRelease:
+        case QEvent::NonClientAreaMouseButtonDblClick:
+            mouseEvent=true;
+            break;
+        case QEvent::Wheel:
+            sviewEvent=true;
+        default:
+            break;
+    }
+
+    bool isSViewCont=sviewEvent && APP_KONTACT==theThemedApp && itsSViewContainers.contains((QWidget*)object);
+
+    if(mouseEvent && isClass(object, WC_MENUBAR))
     {
         if(updateMenuBarEvent((QMouseEvent *)event, (QMenuBar*)object))
             return true;
     }
 
-    if (QEvent::Show==event->type() && qobject_cast<QAbstractScrollArea *>(object) && object->inherits("KFilePlacesView"))
+    if (QEvent::Show==event->type() && qobject_cast<QAbstractScrollArea *>(object) && isClass(object, WC_KFILE_PLACES_VIEW))
     {
         QWidget  *view   = ((QAbstractScrollArea *)object)->viewport();
         QPalette palette = view->palette();
@@ -2727,7 +3000,7 @@ bool Style::eventFilter(QObject *object, QEvent *event)
         object->removeEventFilter(this);
     }
 
-    if((!opts.gtkScrollViews &&  ::qobject_cast<QAbstractScrollArea *>(object)) || isSViewCont)
+    if(sviewEvent && ((!opts.gtkScrollViews && isClass(object, WC_SCROLL_AREA)) || isSViewCont))
     {
         QPoint pos;
         switch(event->type())
@@ -2804,13 +3077,10 @@ bool Style::eventFilter(QObject *object, QEvent *event)
         }
     }
 
-    switch((int)(event->type()))
+    switch(type)
     {
-        case QEvent::Timer:
-        case QEvent::Move:
-            return false; // just for performance - they can occur really often
         case QEvent::Resize:
-            if(!(opts.square&SQUARE_POPUP_MENUS) && object->inherits("QComboBoxPrivateContainer"))
+            if(!(opts.square&SQUARE_POPUP_MENUS) && isClass(object, WC_COMBO_CONTAINER))
             {
                 QWidget *widget=static_cast<QWidget *>(object);
                 if(Utils::hasAlphaChannel(widget))
@@ -2869,12 +3139,24 @@ bool Style::eventFilter(QObject *object, QEvent *event)
             QWidget *widget=qobject_cast<QWidget *>(object);
 
             if(widget && widget->isWindow() && ((widget->windowFlags()&Qt::WindowType_Mask) & (Qt::Window|Qt::Dialog)))
+            {
                 setBgndProp(widget, opts.bgndAppearance, IMG_NONE!=opts.bgndImage.type);
+                emitWindowPropertiesChanged(widget);
+            }
             break;
         }
 #endif
         case QEvent::Paint:
         {
+            // A suspended progress bar animation restarts as soon as a bar that needs it is painted again...
+            if(0==itsProgressBarAnimateTimer && !itsProgressBars.isEmpty())
+            {
+                QProgressBar *bar=qobject_cast<QProgressBar *>(object);
+
+                if(bar && itsProgressBars.contains(bar) && progressBarAnimates(bar))
+                    startProgressBarTimer();
+            }
+
             if(CUSTOM_BGND)
             {
                 QWidget *widget=qobject_cast<QWidget *>(object);
@@ -2898,7 +3180,7 @@ bool Style::eventFilter(QObject *object, QEvent *event)
             //bool isCombo=false;
             if((!IS_FLAT_BGND(opts.menuBgndAppearance) || IMG_NONE!=opts.menuBgndImage.type || 100!=opts.menuBgndOpacity ||
                 !(opts.square&SQUARE_POPUP_MENUS)) &&
-                (qobject_cast<QMenu*>(object) || (/*isCombo=*/object->inherits("QComboBoxPrivateContainer"))))
+                (qobject_cast<QMenu*>(object) || (/*isCombo=*/isClass(object, WC_COMBO_CONTAINER))))
             {
                 QWidget      *widget=qobject_cast<QWidget *>(object);
                 QPainter     p(widget);
@@ -3048,12 +3330,11 @@ bool Style::eventFilter(QObject *object, QEvent *event)
             {
                 itsProgressBars.insert(bar);
                 if (1==itsProgressBars.size())
-                {
                     itsTimer.start();
-                    itsProgressBarAnimateTimer = startTimer(1000 / constProgressBarFps);
-                }
+                if (progressBarAnimates(bar))
+                    startProgressBarTimer();
             }
-            else if(!(opts.square&SQUARE_POPUP_MENUS) && object->inherits("QComboBoxPrivateContainer"))
+            else if(!(opts.square&SQUARE_POPUP_MENUS) && isClass(object, WC_COMBO_CONTAINER))
             {
                 QWidget *widget=static_cast<QWidget *>(object);
                 if(Utils::hasAlphaChannel(widget))
@@ -3107,7 +3388,7 @@ bool Style::eventFilter(QObject *object, QEvent *event)
             if(object && !itsProgressBars.isEmpty())
             {
                 itsProgressBars.remove(reinterpret_cast<QProgressBar*>(object));
-                if (itsProgressBars.isEmpty())
+                if (itsProgressBars.isEmpty() && 0!=itsProgressBarAnimateTimer)
                 {
                     killTimer(itsProgressBarAnimateTimer);
                     itsProgressBarAnimateTimer = 0;
@@ -3131,7 +3412,7 @@ bool Style::eventFilter(QObject *object, QEvent *event)
             break;
         }
         case QEvent::Enter:
-            if(object->isWidgetType() && object->inherits("Q3Header"))
+            if(object->isWidgetType() && isClass(object, WC_Q3_HEADER))
             {
                 itsHoverWidget=(QWidget *)object;
 
@@ -3152,7 +3433,7 @@ bool Style::eventFilter(QObject *object, QEvent *event)
         {
             QMouseEvent *me = dynamic_cast<QMouseEvent*>(event);
 
-            if(me && itsHoverWidget && object->isWidgetType() && object->inherits("Q3Header"))
+            if(me && itsHoverWidget && object->isWidgetType() && isClass(object, WC_Q3_HEADER))
             {
                 if(!me->pos().isNull() && me->pos()!=itsPos)
                     itsHoverWidget->repaint();
@@ -3162,7 +3443,7 @@ bool Style::eventFilter(QObject *object, QEvent *event)
         }
         case QEvent::FocusIn:
         case QEvent::FocusOut:
-            if(opts.highlightScrollViews && object->isWidgetType() && object->inherits("Q3ScrollView"))
+            if(opts.highlightScrollViews && object->isWidgetType() && isClass(object, WC_Q3_SCROLLVIEW))
             {
                 ((QWidget *)object)->update();
                 return false;
@@ -3218,16 +3499,70 @@ void Style::timerEvent(QTimerEvent *event)
 {
     if (event->timerId() == itsProgressBarAnimateTimer)
     {
+        int  prevStep(itsAnimateStep);
+        bool animating(false);
+
         itsAnimateStep = itsTimer.elapsed() / (1000 / constProgressBarFps);
         foreach (QProgressBar *bar, itsProgressBars)
-            if ((opts.animatedProgress && 0==itsAnimateStep%2 && bar->value()!=bar->minimum() && bar->value()!=bar->maximum()) ||
-                (0==bar->minimum() && 0==bar->maximum()))
-                bar->update();
+            if (progressBarAnimates(bar) && progressBarShowing(bar))
+            {
+                animating=true;
+                if (0==bar->minimum() && 0==bar->maximum())
+                    bar->update(progressBarAnimRect(bar, prevStep)|progressBarAnimRect(bar, itsAnimateStep));
+                else if (0==itsAnimateStep%2)
+                    bar->update(progressBarAnimRect(bar, itsAnimateStep));
+            }
+
+        // Nothing to animate - so stop waking up. The timer is restarted when a bar that needs animating is shown or
+        // repainted (e.g. its window is restored, or it becomes busy)...
+        if (!animating)
+        {
+            killTimer(itsProgressBarAnimateTimer);
+            itsProgressBarAnimateTimer = 0;
+        }
     }
 
     event->ignore();
 }
 
+bool Style::progressBarAnimates(const QProgressBar *bar) const
+{
+    return (0==bar->minimum() && 0==bar->maximum()) ||
+           (opts.animatedProgress && bar->value()!=bar->minimum() && bar->value()!=bar->maximum());
+}
+
+bool Style::progressBarShowing(const QProgressBar *bar) const
+{
+    return bar->isVisible() && !bar->window()->isMinimized() && !bar->visibleRegion().isEmpty();
+}
+
+void Style::startProgressBarTimer()
+{
+    if (0==itsProgressBarAnimateTimer)
+        itsProgressBarAnimateTimer = startTimer(1000 / constProgressBarFps);
+}
+
+// The part of the bar that changes as the animation advances - the busy indicator's chunk, or the contents.
+QRect Style::progressBarAnimRect(const QProgressBar *bar, int step) const
+{
+    QStyleOptionProgressBarV2 opt;
+
+    opt.initFrom(bar);
+    opt.minimum=bar->minimum();
+    opt.maximum=bar->maximum();
+    opt.progress=bar->value();
+    opt.orientation=bar->orientation();
+    opt.invertedAppearance=bar->invertedAppearance();
+
+    QRect r(subElementRect(SE_ProgressBarContents, &opt, bar));
+
+    if (0==bar->minimum() && 0==bar->maximum())
+        r=busyChunkRect(r, Qt::Vertical==bar->orientation(), step);
+
+    // Allow for the chunk's border/glow...
+    return r.adjusted(-2, -2, 2, 2);
+}
+
 int Style::pixelMetric(PixelMetric metric, const QStyleOption *option, const QWidget *widget) const
 {
     switch((int)metric)
@@ -3351,14 +3686,14 @@ int Style::pixelMetric(PixelMetric metric, const QStyleOption *option, const QWi
         case PM_ButtonDefaultIndicator:
             return 0;
         case PM_DefaultFrameWidth:
-            if ((/*!opts.popupBorder || */opts.gtkComboMenus) && widget && widget->inherits("QComboBoxPrivateContainer"))
+            if ((/*!opts.popupBorder || */opts.gtkComboMenus) && widget && isClass(widget, WC_COMBO_CONTAINER))
                 return opts.gtkComboMenus ? (opts.borderMenuitems || !(opts.square&SQUARE_POPUP_MENUS) ? 2 : 1) : 0;
 
             if ((!opts.gtkScrollViews || (opts.square&SQUARE_SCROLLVIEW)) && isKateView(widget))
                 return (opts.square&SQUARE_SCROLLVIEW) ? 1 : 0;
 
             if ((opts.square&SQUARE_SCROLLVIEW) && widget && !opts.etchEntry &&
-                (::qobject_cast<const QAbstractScrollArea *>(widget) || isKontactPreviewPane(widget) || widget->inherits("Q3ScrollView")))
+                (::qobject_cast<const QAbstractScrollArea *>(widget) || isKontactPreviewPane(widget) || isClass(widget, WC_Q3_SCROLLVIEW)))
                 return (opts.gtkScrollViews || opts.thinSbarGroove || !opts.borderSbarGroove) && (!opts.highlightScrollViews) ? 1 : 2;
 
             if (!DRAW_MENU_BORDER && !opts.borderMenuitems && opts.square&SQUARE_POPUP_MENUS && qobject_cast<const QMenu *>(widget))
@@ -3367,7 +3702,7 @@ int Style::pixelMetric(PixelMetric metric, const QStyleOption *option, const QWi
             if(DO_EFFECT && opts.etchEntry &&
                 (!widget || // !isFormWidget(widget) &&
                 ::qobject_cast<const QLineEdit *>(widget) || ::qobject_cast<const QAbstractScrollArea*>(widget) ||
-                widget->inherits("Q3ScrollView") /*|| isKontactPreviewPane(widget)*/))
+                isClass(widget, WC_Q3_SCROLLVIEW) /*|| isKontactPreviewPane(widget)*/))
                 return 3;
             else
                 return 2;
@@ -3485,7 +3820,7 @@ int Style::pixelMetric(PixelMetric metric, const QStyleOption *option, const QWi
 //.........
         case PM_TabBarBaseHeight:
 #ifdef QTC_QT_ONLY
-            if(widget && widget->inherits("KTabBar") && !qstyleoption_cast<const QStyleOptionTab *>(option))
+            if(widget && isClass(widget, WC_KTABBAR) && !qstyleoption_cast<const QStyleOptionTab *>(option))
 #else
             if(widget && qobject_cast<const KTabBar*>(widget) && !qstyleoption_cast<const QStyleOptionTab *>(option))
 #endif
@@ -3493,7 +3828,7 @@ int Style::pixelMetric(PixelMetric metric, const QStyleOption *option, const QWi
             return BASE_STYLE::pixelMetric(metric, option, widget);
         case PM_TabBarBaseOverlap:
 #ifdef QTC_QT_ONLY
-            if(widget && widget->inherits("KTabBar") && !qstyleoption_cast<const QStyleOptionTab *>(option))
+            if(widget && isClass(widget, WC_KTABBAR) && !qstyleoption_cast<const QStyleOptionTab *>(option))
 #else
             if(widget && qobject_cast<const KTabBar*>(widget) && !qstyleoption_cast<const QStyleOptionTab *>(option))
 #endif
@@ -3643,11 +3978,11 @@ int Style::styleHint(StyleHint hint, const QStyleOption *option, const QWidget *
         case SH_ScrollView_FrameOnlyAroundContents:
             return widget && widget->isWindow()
                     ? false
-                    : opts.gtkScrollViews && (!widget || !widget->inherits("QComboBoxListView"));
+                    : opts.gtkScrollViews && (!widget || !isClass(widget, WC_COMBO_LIST_VIEW));
         case SH_ComboBox_Popup:
             if(opts.gtkComboMenus)
             {
-                if (widget && widget->inherits("Q3ComboBox"))
+                if (widget && isClass(widget, WC_Q3_COMBOBOX))
                     return 0;
                 if (const QStyleOptionComboBox *cmb = qstyleoption_cast<const QStyleOptionComboBox *>(option))
                     return !cmb->editable;
@@ -3961,7 +4296,7 @@ void Style::drawPrimitive(PrimitiveElement element, const QStyleOption *option,
             // disable painting of PE_PanelScrollAreaCorner
             // the default implementation fills the rect with the window background color which does not work for windows that have gradients.
             // ...but need to for WebView!!!
-            if(!opts.gtkScrollViews || !CUSTOM_BGND || (widget && widget->inherits("WebView")))
+            if(!opts.gtkScrollViews || !CUSTOM_BGND || (widget && isClass(widget, WC_WEBVIEW)))
                 painter->fillRect(r, palette.brush(QPalette::Window));
             break;
         case PE_IndicatorBranch:
@@ -4087,7 +4422,7 @@ void Style::drawPrimitive(PrimitiveElement element, const QStyleOption *option,
                                 (opts.unifyCombo && qobject_cast<const QComboBox *>(widget) &&
                                 ((const QComboBox *)widget)->isEditable()))))
                     r.adjust(1, 1, 1, 1);
-                if(col.alpha()<255 && PE_IndicatorArrowRight==element && widget && widget->inherits("KUrlButton"))
+                if(col.alpha()<255 && PE_IndicatorArrowRight==element && widget && isClass(widget, WC_KURL_BUTTON))
                     col=blendColors(col, palette.background().color(), col.alphaF());
 
                 drawArrow(painter, r, element, col, false, false);
@@ -4264,7 +4599,7 @@ void Style::drawPrimitive(PrimitiveElement element, const QStyleOption *option,
                 break;
 
 #ifdef QTC_QT_ONLY
-            if(widget && widget->parent() && widget->parent()->inherits("KTitleWidget"))
+            if(widget && widget->parent() && isClass(widget->parent(), WC_KTITLE_WIDGET))
                 break;
 #else
             if(widget && widget->parent() && qobject_cast<const KTitleWidget *>(widget->parent()))
@@ -4325,7 +4660,7 @@ void Style::drawPrimitive(PrimitiveElement element, const QStyleOption *option,
                          kontactPreview(!kateView && isKontactPreviewPane(widget)),
                          sv(isOOWidget(widget) ||
                             ::qobject_cast<const QAbstractScrollArea *>(widget) ||
-                            (widget && widget->inherits("Q3ScrollView")) ||
+                            (widget && isClass(widget, WC_Q3_SCROLLVIEW)) ||
                             ((opts.square&SQUARE_SCROLLVIEW) && (kateView || kontactPreview))),
                         squareSv(sv && ((opts.square&SQUARE_SCROLLVIEW) || (widget && widget->isWindow()))),
                         inQAbstractItemView(widget && widget->parentWidget() && isInQAbstractItemView(widget->parentWidget()));
@@ -4413,7 +4748,7 @@ void Style::drawPrimitive(PrimitiveElement element, const QStyleOption *option,
         }
         case PE_PanelMenuBar:
             if (widget && widget->parentWidget() && (qobject_cast<const QMainWindow *>(widget->parentWidget()) ||
-                                                     widget->parentWidget()->inherits("Q3MainWindow")))
+                                                     isClass(widget->parentWidget(), WC_Q3_MAIN_WINDOW)))
             {
                 painter->save();
                 if(!opts.xbar || (!widget || 0!=strcmp("QWidget", widget->metaObject()->className())))
@@ -4556,8 +4891,8 @@ void Style::drawPrimitive(PrimitiveElement element, const QStyleOption *option,
             }
         case PE_IndicatorButtonDropDown: // This should never be called, but just in case - draw as a normal toolbutton...
         {
-            bool dwt(widget && widget->inherits("QDockWidgetTitleButton")),
-                 koDwt(!dwt && widget && widget->parentWidget() && widget->parentWidget()->inherits("KoDockWidgetTitleBar"));
+            bool dwt(widget && isClass(widget, WC_DOCK_TITLE_BUTTON)),
+                 koDwt(!dwt && widget && widget->parentWidget() && isClass(widget->parentWidget(), WC_KO_DOCK_TITLE_BAR));
 
             if( ((state&State_Enabled) || !(state&State_AutoRaise)) &&
                (!widget || !(dwt || koDwt)|| (state&State_MouseOver)) )
@@ -4795,9 +5130,9 @@ void Style::drawPrimitive(PrimitiveElement element, const QStyleOption *option,
 
             if(state&State_On || selectedOOMenu)
             {
-                QPixmap *pix(getPixmap(checkRadioCol(option), PIX_CHECK, 1.0));
+                QPixmap pix(getPixmap(checkRadioCol(option), PIX_CHECK, 1.0));
 
-                painter->drawPixmap(rect.center().x()-(pix->width()/2), rect.center().y()-(pix->height()/2), *pix);
+                painter->drawPixmap(rect.center().x()-(pix.width()/2), rect.center().y()-(pix.height()/2), pix);
             }
             else if (state&State_NoChange)    // tri-state
             {
@@ -4958,7 +5293,7 @@ void Style::drawPrimitive(PrimitiveElement element, const QStyleOption *option,
             if (const QStyleOptionFocusRect *focusFrame = qstyleoption_cast<const QStyleOptionFocusRect *>(option))
             {
                 if (!(focusFrame->state&State_KeyboardFocusChange) ||
-                    (widget && widget->inherits("QComboBoxListView")))
+                    (widget && isClass(widget, WC_COMBO_LIST_VIEW)))
                     return;
 
                 if(widget && FOCUS_GLOW==opts.focus)
@@ -5012,10 +5347,10 @@ void Style::drawPrimitive(PrimitiveElement element, const QStyleOption *option,
                     //Figuring out in what beast we are painting...
                     bool view(state&State_Item ||
                               ((widget && ((qobject_cast<const QAbstractScrollArea*>(widget)) ||
-                                        widget->inherits("Q3ScrollView"))) ||
+                                        isClass(widget, WC_Q3_SCROLLVIEW))) ||
                                          (widget && widget->parent() &&
                                             ((qobject_cast<const QAbstractScrollArea*>(widget->parent())) ||
-                                              widget->parent()->inherits("Q3ScrollView")))) );
+                                              isClass(widget->parent(), WC_Q3_SCROLLVIEW)))) );
 
                     if(!view && !widget)
                     {
@@ -5024,13 +5359,13 @@ void Style::drawPrimitive(PrimitiveElement element, const QStyleOption *option,
 
                         if(wid && wid->parentWidget())
                         {
-                            if(wid->parentWidget()->inherits("KDEPrivate::KPageListView"))
+                            if(isClass(wid->parentWidget(), WC_KPAGE_LIST_VIEW))
                             {
                                 r2.adjust(2, 2, -2, -2);
                                 view=true;
                             }
-                            else if(APP_KONTACT==theThemedApp && (wid->parentWidget()->inherits("KMail::MainFolderView") ||
-                                                                  wid->parentWidget()->inherits("MessageList::Core::View")))
+                            else if(APP_KONTACT==theThemedApp && (isClass(wid->parentWidget(), WC_KMAIL_FOLDER_VIEW) ||
+                                                                  isClass(wid->parentWidget(), WC_KMAIL_MESSAGE_LIST)))
                             {
                                 view=true;
                             }
@@ -5063,7 +5398,7 @@ void Style::drawPrimitive(PrimitiveElement element, const QStyleOption *option,
                         {
                             bool square((opts.square&SQUARE_LISTVIEW_SELECTION) &&
                                         ( (/*(!widget && r.height()<=40 && r.width()>=48) || */
-                                          (widget && !widget->inherits("KFilePlacesView") &&
+                                          (widget && !isClass(widget, WC_KFILE_PLACES_VIEW) &&
                                           (qobject_cast<const QTreeView *>(widget) ||
                                             (qobject_cast<const QListView *>(widget) &&
                                              QListView::IconMode!=((const QListView *)widget)->viewMode())))) ||
@@ -5148,7 +5483,7 @@ void Style::drawPrimitive(PrimitiveElement element, const QStyleOption *option,
                 else if(constDwtFloat==widget->objectName())
                     use=itsTitleBarButtonsCols[TITLEBAR_MAX];
                 else if(widget->parentWidget() && widget->parentWidget()->parentWidget() &&
-                        widget->parentWidget()->inherits("KoDockWidgetTitleBar") &&
+                        isClass(widget->parentWidget(), WC_KO_DOCK_TITLE_BAR) &&
                         ::qobject_cast<QDockWidget *>(widget->parentWidget()->parentWidget()))
                 {
                     QDockWidget              *dw   = (QDockWidget *)widget->parentWidget()->parentWidget();
@@ -5449,7 +5784,7 @@ void Style::drawPrimitive(PrimitiveElement element, const QStyleOption *option,
                                 : palette.color(cg, QPalette::Highlight));
                 bool   square((opts.square&SQUARE_LISTVIEW_SELECTION) &&
                               (/*(!widget && r.height()<=40 && r.width()>=48) || */
-                               (widget && !widget->inherits("KFilePlacesView") &&
+                               (widget && !isClass(widget, WC_KFILE_PLACES_VIEW) &&
                                 (qobject_cast<const QTreeView *>(widget) ||
                                   (qobject_cast<const QListView *>(widget) &&
                                   QListView::IconMode!=((const QListView *)widget)->viewMode()))))),
@@ -5474,17 +5809,16 @@ void Style::drawPrimitive(PrimitiveElement element, const QStyleOption *option,
                 else
                 {
                     QPixmap pix;
-                    QString key;
+                    double  radius(qtcGetRadius(&opts, r.width(), r.height(), WIDGET_OTHER, RADIUS_SELECTION));
+                    QtcKey  key(createSelectionKey(color, r.height(), radius));
 
-                    key.sprintf("qtc-sel-%x-%x", r.height(), color.rgba());
-                    if(!itsUsePixmapCache || !QPixmapCache::find(key, pix))
+                    if(!itsPixmapCache.find(key, pix))
                     {
                         pix=QPixmap(QSize(24, r.height()));
                         pix.fill(Qt::transparent);
 
                         QPainter pixPainter(&pix);
                         QRect    border(0, 0, pix.width(), pix.height());
-                        double   radius(qtcGetRadius(&opts, r.width(), r.height(), WIDGET_OTHER, RADIUS_SELECTION));
 
                         pixPainter.setRenderHint(QPainter::Antialiasing, true);
                         drawBevelGradient(color, &pixPainter, border, buildPath(QRectF(border), WIDGET_OTHER, ROUNDED_ALL, radius), true,
@@ -5496,8 +5830,7 @@ void Style::drawPrimitive(PrimitiveElement element, const QStyleOption *option,
                             pixPainter.drawPath(buildPath(border, WIDGET_SELECTION, ROUNDED_ALL, radius));
                         }
                         pixPainter.end();
-                        if(itsUsePixmapCache)
-                            QPixmapCache::insert(key, pix);
+                        itsPixmapCache.insert(key, pix);
                     }
 
                     bool roundedLeft  = false,
@@ -5602,6 +5935,11 @@ void Style::drawControl(ControlElement element, const QStyleOption *option, QPai
                 if(!painter && widget && QLatin1String("QtCurveConfigDialog")==widget->objectName())
                 {
                     Style *that=(Style *)this;
+                    // The tile keys do not cover every setting that can be changed in the dialog, and the
+                    // shades depend upon customShades and contrast - so drop anything cached for the previous
+                    // settings.
+                    itsPixmapCache.clear();
+                    itsShadeCache.clear();
                     opts=preview->opts;
                     qtcCheckConfig(&opts);
                     that->init(true);
@@ -5630,7 +5968,7 @@ void Style::drawControl(ControlElement element, const QStyleOption *option, QPai
 
                 if(mod.rect.height()>16 && widget->parentWidget() &&
                    (qobject_cast<const QStatusBar *>(widget->parentWidget()) ||
-                    widget->parentWidget()->inherits("DolphinStatusBar")))
+                    isClass(widget->parentWidget(), WC_DOLPHIN_STATUSBAR)))
                 {
                     int m=(mod.rect.height()-16)/2;
                     mod.rect.adjust(0, m, 0, -m);
@@ -5756,7 +6094,7 @@ void Style::drawControl(ControlElement element, const QStyleOption *option, QPai
                 case LINE_NONE:
                     break;
                 case LINE_1DOT:
-                    painter->drawPixmap(r.x()+((r.width()-5)/2), r.y()+((r.height()-5)/2), *getPixmap(border[STD_BORDER], PIX_DOT, 1.0));
+                    painter->drawPixmap(r.x()+((r.width()-5)/2), r.y()+((r.height()-5)/2), getPixmap(border[STD_BORDER], PIX_DOT, 1.0));
                     break;
                 default:
                 case LINE_DOTS:
@@ -5876,7 +6214,7 @@ void Style::drawControl(ControlElement element, const QStyleOption *option, QPai
 #else
                 bool                           verticalTitleBar(false);
 #endif
-                bool                           isKOffice(widget && widget->inherits("KoDockWidgetTitleBar"));
+                bool                           isKOffice(widget && isClass(widget, WC_KO_DOCK_TITLE_BAR));
                 QRect                          fillRect(r);
 
                 // This fixes the look of KOffice's dock widget titlebars...
@@ -6051,7 +6389,7 @@ void Style::drawControl(ControlElement element, const QStyleOption *option, QPai
                 if(state & (State_Raised | State_Sunken))
                 {
                     bool         sunken(state &(/*State_Down |*/ /*State_On | */State_Sunken)),
-                                 q3Header(widget && widget->inherits("Q3Header"));
+                                 q3Header(widget && isClass(widget, WC_Q3_HEADER));
                     QStyleOption opt(*option);
 
                     opt.state&=~State_On;
@@ -6223,23 +6561,7 @@ void Style::drawControl(ControlElement element, const QStyleOption *option, QPai
                 painter->save();
 
                 if(indeterminate) //Busy indicator
-                {
-                    int chunkSize(PROGRESS_CHUNK_WIDTH*3.4),
-                        measure(vertical ? r.height() : r.width());
-
-                    if(chunkSize>(measure/2))
-                        chunkSize=measure/2;
-
-                    int          step(itsAnimateStep % ((measure-chunkSize) * 2));
-                    QStyleOption opt(*option);
-
-                    if (step > (measure-chunkSize))
-                        step = 2 * (measure-chunkSize) - step;
-
-                    opt.state|=State_Raised|State_Horizontal;
-                    drawProgress(painter, vertical ? QRect(r.x(), r.y()+step, r.width(), chunkSize) : QRect(r.x()+step, r.y(), chunkSize, r.height()),
-                                 option, vertical);
-                }
+                    drawProgress(painter, busyChunkRect(r, vertical, itsAnimateStep), option, vertical);
                 else if(r.isValid() && bar->progress>0)
                 {
                     qint64 progress = qMax<qint64>(bar->progress, bar->minimum); // workaround for bug in QProgressBar
@@ -6861,7 +7183,7 @@ void Style::drawControl(ControlElement element, const QStyleOption *option, QPai
                 if(!opts.xbar || (!widget || 0!=strcmp("QWidget", widget->metaObject()->className())))
                     drawMenuOrToolBarBackground(widget, painter, r, option);
                 if (TB_NONE!=opts.toolbarBorders && widget && widget->parentWidget() &&
-                    (qobject_cast<const QMainWindow *>(widget->parentWidget()) || widget->parentWidget()->inherits("Q3MainWindow")))
+                    (qobject_cast<const QMainWindow *>(widget->parentWidget()) || isClass(widget->parentWidget(), WC_Q3_MAIN_WINDOW)))
                 {
                     const QColor *use=menuColors(option, itsActive);
                     bool         dark(TB_DARK==opts.toolbarBorders || TB_DARK_ALL==opts.toolbarBorders);
@@ -8009,8 +8331,8 @@ void Style::drawComplexControl(ComplexControl control, const QStyleOptionComplex
                 if (widget)
                 {
                     if((opts.dwtSettings&DWT_BUTTONS_AS_PER_TITLEBAR) &&
-                        (widget->inherits("QDockWidgetTitleButton") ||
-                         (widget->parentWidget() && widget->parentWidget()->inherits("KoDockWidgetTitleBar"))))
+                        (isClass(widget, WC_DOCK_TITLE_BUTTON) ||
+                         (widget->parentWidget() && isClass(widget->parentWidget(), WC_KO_DOCK_TITLE_BAR))))
                     {
                         ETitleBarButtons btn=TITLEBAR_CLOSE;
                         Icon             icon=ICN_CLOSE;
@@ -8019,7 +8341,7 @@ void Style::drawComplexControl(ComplexControl control, const QStyleOptionComplex
                             btn=TITLEBAR_MAX, icon=ICN_RESTORE;
                         else if(constDwtClose!=widget->objectName() &&
                                 widget->parentWidget() && widget->parentWidget()->parentWidget() &&
-                                widget->parentWidget()->inherits("KoDockWidgetTitleBar") &&
+                                isClass(widget->parentWidget(), WC_KO_DOCK_TITLE_BAR) &&
                                 ::qobject_cast<QDockWidget *>(widget->parentWidget()->parentWidget()))
                         {
                             QDockWidget              *dw   = (QDockWidget *)widget->parentWidget()->parentWidget();
@@ -8136,7 +8458,7 @@ void Style::drawComplexControl(ComplexControl control, const QStyleOptionComplex
 
                     // Amarok's toolbars (the one just above the collection list) are much thinner then normal,
                     // and QToolBarExtension does not seem to take this into account - so adjust the size here...
-                    if(widget->inherits("QToolBarExtension") && widget->parentWidget())
+                    if(isClass(widget, WC_TOOLBAR_EXTENSION) && widget->parentWidget())
                     {
                         if(r.height()>widget->parentWidget()->rect().height())
                             heightAdjust=(r.height()-widget->parentWidget()->rect().height())+2;
@@ -9267,12 +9589,12 @@ void Style::drawComplexControl(ComplexControl control, const QStyleOptionComplex
 
                 bool needsBaseBgnd=(opts.thinSbarGroove || opts.flatSbarButtons) &&
                                    widget && widget->parentWidget() && widget->parentWidget()->parentWidget() &&
-                                   (widget->parentWidget()->parentWidget()->inherits("QComboBoxListView")/* ||
+                                   (isClass(widget->parentWidget()->parentWidget(), WC_COMBO_LIST_VIEW)/* ||
                                     !opts.gtkScrollViews && widget->parentWidget()->parentWidget()->inherits("QAbstractScrollArea")*/);
 
                 if(needsBaseBgnd)
                     painter->fillRect(r, palette.brush(QPalette::Base));
-                else if(opts.thinSbarGroove && APP_ARORA==theThemedApp && widget && widget->inherits("WebView"))
+                else if(opts.thinSbarGroove && APP_ARORA==theThemedApp && widget && isClass(widget, WC_WEBVIEW))
                     painter->fillRect(r, itsBackgroundCols[ORIGINAL_SHADE]);
 
                 if(!opts.gtkScrollViews ||
@@ -9687,7 +10009,7 @@ QSize Style::sizeFromContents(ContentsType type, const QStyleOption *option, con
                             // Cant rely on AutoDefaultButton - as VirtualBox does not set this!!!
                             // btn->features&QStyleOptionButton::AutoDefaultButton &&
                             widget && widget->parentWidget() &&
-                            (::qobject_cast<const QDialogButtonBox *>(widget->parentWidget()) || widget->parentWidget()->inherits("KFileWidget"));
+                            (::qobject_cast<const QDialogButtonBox *>(widget->parentWidget()) || isClass(widget->parentWidget(), WC_KFILE_WIDGET));
 
                     if(dialogButton)
                     {
@@ -10843,18 +11165,17 @@ void Style::drawLines(QPainter *p, const QRect &r, bool horiz, int nLines, int o
 void Style::drawProgressBevelGradient(QPainter *p, const QRect &origRect, const QStyleOption *option, bool horiz, EAppearance bevApp,
                                       const QColor *cols) const
 {
-    bool    vertical(!horiz),
-            inCache(true);
+    bool    vertical(!horiz);
     QRect   r(0, 0, horiz ? PROGRESS_CHUNK_WIDTH*2 : origRect.width(),
                     horiz ? origRect.height() : PROGRESS_CHUNK_WIDTH*2);
     QtcKey  key(createKey(horiz ? r.height() : r.width(), cols[ORIGINAL_SHADE], horiz, bevApp, WIDGET_PROGRESSBAR));
-    QPixmap *pix(itsPixmapCache.object(key));
+    QPixmap pix;
 
-    if(!pix)
+    if(!itsPixmapCache.find(key, pix))
     {
-        pix=new QPixmap(r.width(), r.height());
+        pix=QPixmap(r.width(), r.height());
 
-        QPainter pixPainter(pix);
+        QPainter pixPainter(&pix);
 
         if(IS_FLAT(bevApp))
             pixPainter.fillRect(r, cols[ORIGINAL_SHADE]);
@@ -10880,8 +11201,21 @@ void Style::drawProgressBevelGradient(QPainter *p, const QRect &origRect, const
             }
             case STRIPE_DIAGONAL:
             {
-                QRegion reg;
-                int     size(vertical ? origRect.width() : origRect.height());
+                // Fill the stripes with a pattern brush of the stripe colour, rather than clipping to a union of regions
+                QPixmap      stripe(r.size());
+                QPainterPath stripes;
+                int          size(vertical ? origRect.width() : origRect.height());
+
+                if(IS_FLAT(bevApp))
+                    stripe.fill(cols[1]);
+                else
+                {
+                    stripe.fill(Qt::transparent);
+
+                    QPainter stripePainter(&stripe);
+
+                    drawBevelGradientReal(cols[1], &stripePainter, r, horiz, false, bevApp, WIDGET_PROGRESSBAR);
+                }
 
                 for(int offset=0; offset<(size*2); offset+=(PROGRESS_CHUNK_WIDTH*2))
                 {
@@ -10898,26 +11232,19 @@ void Style::drawProgressBevelGradient(QPainter *p, const QRect &origRect, const
                                        (r.x()+offset+PROGRESS_CHUNK_WIDTH)-size, r.y()+r.height(),
                                        (r.x()+offset)-size,                      r.y()+r.height());
 
-                    reg+=QRegion(a);
+                    stripes.addPolygon(a);
+                    stripes.closeSubpath();
                 }
 
-                pixPainter.setClipRegion(reg);
-                if(IS_FLAT(bevApp))
-                    pixPainter.fillRect(r, cols[1]);
-                else
-                    drawBevelGradientReal(cols[1], &pixPainter, r, horiz, false, bevApp, WIDGET_PROGRESSBAR);
+                pixPainter.fillPath(stripes, QBrush(stripe));
             }
         }
 
         pixPainter.end();
-        int cost(pix->width()*pix->height()*(pix->depth()/8));
-
-        if(cost<itsPixmapCache.maxCost())
-            itsPixmapCache.insert(key, pix, cost);
-        else
-            inCache=false;
+        itsPixmapCache.insert(key, pix);
     }
     QRect fillRect(origRect);
+    int   offset(0);
 
     if(opts.animatedProgress)
     {
@@ -10932,17 +11259,22 @@ void Style::drawProgressBevelGradient(QPainter *p, const QRect &origRect, const
             fillRect.adjust(animShift-PROGRESS_CHUNK_WIDTH, 0, PROGRESS_CHUNK_WIDTH, 0);
         else
             fillRect.adjust(0, animShift-PROGRESS_CHUNK_WIDTH, 0, PROGRESS_CHUNK_WIDTH);
+
+        // The strip repeats every PROGRESS_CHUNK_WIDTH*2 pixels, so animating is just a matter of where in the
+        // strip the tiling starts...
+        offset=(horiz ? origRect.x()-fillRect.x() : origRect.y()-fillRect.y()) % (PROGRESS_CHUNK_WIDTH*2);
+        if(offset<0)
+            offset+=PROGRESS_CHUNK_WIDTH*2;
     }
 
-    p->save();
-    p->setClipRect(origRect, Qt::IntersectClip);
-    p->drawTiledPixmap(fillRect, *pix);
+    p->drawTiledPixmap(origRect, pix, horiz ? QPoint(offset, 0) : QPoint(0, offset));
     if(STRIPE_FADE==opts.stripedProgress && fillRect.width()>4 && fillRect.height()>4)
+    {
+        p->save();
+        p->setClipRect(origRect, Qt::IntersectClip);
         addStripes(p, QPainterPath(), fillRect, !vertical);
-    p->restore();
-
-    if(!inCache)
-        delete pix;
+        p->restore();
+    }
 }
 
 void Style::drawBevelGradient(const QColor &base, QPainter *p, const QRect &origRect, const QPainterPath &path,
@@ -10981,25 +11313,18 @@ void Style::drawBevelGradient(const QColor &base, QPainter *p, const QRect &orig
             QRect   r(0, 0, horiz ? PIXMAP_DIMENSION : origRect.width(),
                             horiz ? origRect.height() : PIXMAP_DIMENSION);
             QtcKey  key(createKey(horiz ? r.height() : r.width(), base, horiz, app, w));
-            QPixmap *pix(itsPixmapCache.object(key));
-            bool    inCache(true);
+            QPixmap pix;
 
-            if(!pix)
+            if(!itsPixmapCache.find(key, pix))
             {
-                pix=new QPixmap(r.width(), r.height());
-                pix->fill(Qt::transparent);
+                pix=QPixmap(r.width(), r.height());
+                pix.fill(Qt::transparent);
 
-                QPainter pixPainter(pix);
+                QPainter pixPainter(&pix);
 
                 drawBevelGradientReal(base, &pixPainter, r, horiz, sel, app, w);
                 pixPainter.end();
-
-                int cost(pix->width()*pix->height()*(pix->depth()/8));
-
-                if(cost<itsPixmapCache.maxCost())
-                    itsPixmapCache.insert(key, pix, cost);
-                else
-                    inCache=false;
+                itsPixmapCache.insert(key, pix);
             }
 
             if(!path.isEmpty())
@@ -11008,11 +11333,9 @@ void Style::drawBevelGradient(const QColor &base, QPainter *p, const QRect &orig
                 p->setClipPath(path, Qt::IntersectClip);
             }
 
-            p->drawTiledPixmap(origRect, *pix);
+            p->drawTiledPixmap(origRect, pix);
             if(!path.isEmpty())
                 p->restore();
-            if(!inCache)
-                delete pix;
         }
     }
 }
@@ -11028,52 +11351,88 @@ void Style::drawBevelGradientReal(const QColor &base, QPainter *p, const QRect &
                                                      (opts.dwtSettings&DWT_COLOR_AS_PER_TITLEBAR &&
                                                                      WIDGET_DOCK_WIDGET_TITLE==w && !dwt))),
                                      reverse(Qt::RightToLeft==QApplication::layoutDirection());
-    const Gradient                   *grad=qtcGetGradient(app, &opts);
-    QLinearGradient                  g(r.topLeft(), horiz ? r.bottomLeft() : r.topRight());
-    GradientStopCont::const_iterator it(grad->stops.begin()),
-                                     end(grad->stops.end());
-    int                              numStops(grad->stops.size());
+    int                              length(horiz ? r.height() : r.width());
+
+    if(length<1)
+        return;
 
-    for(int i=0; it!=end; ++it, ++i)
+    // The gradient only varies along its axis, so it is baked into a cached 1 pixel wide ramp, which is then
+    // tiled across the rect (or used as the brush for the path). Ramps are keyed on their exact length, so there
+    // is one for every size a widget is resized through - these are cheap to render, so only kept in memory, and
+    // not stored in the shared, or disk, caches...
+    int     flags((horiz ? RAMP_HORIZ : 0)|(sel ? RAMP_SEL : 0)|(topTab ? RAMP_TOP_TAB : 0)|(botTab ? RAMP_BOT_TAB : 0)|
+                  (dwt ? RAMP_DWT : 0)|(titleBar ? RAMP_TITLEBAR : 0)|(reverse ? RAMP_REVERSE : 0)|
+                  (WIDGET_TOOLTIP==w ? RAMP_TOOLTIP : 0));
+    bool    useCache(length<=0xFFFF);
+    QtcKey  key(createRampKey(base, app, flags, length, itsBackgroundCols[ORIGINAL_SHADE]));
+    QPixmap ramp;
+
+    if(!useCache || !itsPixmapCache.find(key, ramp, false))
     {
-        QColor col;
+        const Gradient                   *grad=qtcGetGradient(app, &opts);
+        QRect                            rr(0, 0, horiz ? 1 : length, horiz ? length : 1);
+        QLinearGradient                  g(rr.topLeft(), horiz ? rr.bottomLeft() : rr.topRight());
+        GradientStopCont::const_iterator it(grad->stops.begin()),
+                                         end(grad->stops.end());
+        int                              numStops(grad->stops.size());
 
-        if(/*sel && */(topTab || botTab || dwt || titleBar) && i==numStops-1)
+        for(int i=0; it!=end; ++it, ++i)
         {
-            if(titleBar)
+            QColor col;
+
+            if(/*sel && */(topTab || botTab || dwt || titleBar) && i==numStops-1)
             {
-                col=itsBackgroundCols[ORIGINAL_SHADE];
-                //if(APPEARANCE_STRIPED==opts.bgndAppearance)
-                    col.setAlphaF(0.0);
+                if(titleBar)
+                {
+                    col=itsBackgroundCols[ORIGINAL_SHADE];
+                    //if(APPEARANCE_STRIPED==opts.bgndAppearance)
+                        col.setAlphaF(0.0);
+                }
+                else
+                {
+                    col=base;
+                    if((sel /*&& CUSTOM_BGND*/ && 0==opts.tabBgnd && !reverse) || dwt)
+                        col.setAlphaF(0.0);
+                }
             }
             else
-            {
-                col=base;
-                if((sel /*&& CUSTOM_BGND*/ && 0==opts.tabBgnd && !reverse) || dwt)
-                    col.setAlphaF(0.0);
-            }
+                shade(base, &col, botTab && opts.invertBotTab ? qMax(INVERT_SHADE((*it).val), 0.9) : (*it).val);
+            if(WIDGET_TOOLTIP!=w && (*it).alpha<1.0)
+                col.setAlphaF(col.alphaF()*(*it).alpha);
+            g.setColorAt(botTab ? 1.0-(*it).pos : (*it).pos, col);
         }
-        else
-            shade(base, &col, botTab && opts.invertBotTab ? qMax(INVERT_SHADE((*it).val), 0.9) : (*it).val);
-        if(WIDGET_TOOLTIP!=w && (*it).alpha<1.0)
-            col.setAlphaF(col.alphaF()*(*it).alpha);
-        g.setColorAt(botTab ? 1.0-(*it).pos : (*it).pos, col);
-    }
 
-    if(APPEARANCE_AGUA==app && !(topTab || botTab || dwt) && (horiz ? r.height() : r.width())>AGUA_MAX)
-    {
-        QColor col;
-        double pos=AGUA_MAX/((horiz ? r.height() : r.width())*2.0);
-        shade(base, &col, AGUA_MID_SHADE);
-        g.setColorAt(pos, col);
-        g.setColorAt(1.0-pos, col);
+        if(APPEARANCE_AGUA==app && !(topTab || botTab || dwt) && length>AGUA_MAX)
+        {
+            QColor col;
+            double pos=AGUA_MAX/(length*2.0);
+            shade(base, &col, AGUA_MID_SHADE);
+            g.setColorAt(pos, col);
+            g.setColorAt(1.0-pos, col);
+        }
+
+        ramp=QPixmap(rr.size());
+        ramp.fill(Qt::transparent);
+
+        QPainter rampPainter(&ramp);
+
+        rampPainter.fillRect(rr, QBrush(g));
+        rampPainter.end();
+        if(useCache)
+            itsPixmapCache.insert(key, ramp, false);
     }
 
     //p->fillRect(r, base);
     if(path.isEmpty())
-        p->fillRect(r, QBrush(g));
+        p->drawTiledPixmap(r, ramp);
     else
-        p->fillPath(path, QBrush(g));
+    {
+        const QPointF prevOrigin(p->brushOrigin());
+
+        p->setBrushOrigin(r.topLeft());
+        p->fillPath(path, QBrush(ramp));
+        p->setBrushOrigin(prevOrigin);
+    }
 }
 
 void Style::drawSunkenBevel(QPainter *p, const QRect &r, const QColor &col) const
@@ -11105,7 +11464,7 @@ void Style::drawLightBevel(QPainter *p, const QRect &r, const QStyleOption *opti
 {
     bool onToolbar=APPEARANCE_NONE!=opts.tbarBtnAppearance && (WIDGET_TOOLBAR_BUTTON==w || (WIDGET_BUTTON(w) && isOnToolbar(widget)));
 
-    if(WIDGET_PROGRESSBAR==w || WIDGET_SB_BUTTON==w || (WIDGET_SPIN==w && !opts.unifySpin)/* || !itsUsePixmapCache*/)
+    if(WIDGET_PROGRESSBAR==w || WIDGET_SB_BUTTON==w || (WIDGET_SPIN==w && !opts.unifySpin))
         drawLightBevelReal(p, r, option, widget, round, fill, custom, doBorder, w, true, opts.round, onToolbar);
     else
     {
@@ -11151,18 +11510,17 @@ void Style::drawLightBevel(QPainter *p, const QRect &r, const QStyleOption *opti
             drawLightBevelReal(p, r, option, widget, round, fill, custom, doBorder, w, true, realRound, onToolbar);
         else
         {
-            QString key;
             bool    small(circular || (horiz ? r.width() : r.height())<(2*endSize));
-            QPixmap pix;
+            TileSet tiles;
             QSize   pixSize(small ? QSize(r.width(), r.height()) : QSize(horiz ? size : r.width(), horiz ? r.height() : size));
             uint    state(option->state&(State_Raised|State_Sunken|State_On|State_Horizontal|State_HasFocus|State_MouseOver|
                           (WIDGET_MDI_WINDOW_BUTTON==w ? State_Active : State_None)));
 
-            key.sprintf("qtc-%x-%x-%x-%x-%x-%x-%x-%x-%x", w, onToolbar ? 1 : 0, round, (int)realRound, pixSize.width(), pixSize.height(),
-                        state, fill.rgba(), (int)(radius*100));
-            if(!itsUsePixmapCache || !QPixmapCache::find(key, pix))
+            QtcKey  key(createBevelKey(w, onToolbar, round, realRound, pixSize, state, fill, radius));
+
+            if(!itsPixmapCache.find(key, tiles))
             {
-                pix=QPixmap(pixSize);
+                QPixmap pix(pixSize);
                 pix.fill(Qt::transparent);
 
                 QPainter pixPainter(&pix);
@@ -11173,29 +11531,12 @@ void Style::drawLightBevel(QPainter *p, const QRect &r, const QStyleOption *opti
                 opts.round=oldRound;
                 pixPainter.end();
 
-                if(itsUsePixmapCache)
-                    QPixmapCache::insert(key, pix);
+                // Slice once, here, so that painting from the cache is just blits...
+                tiles=small ? TileSet(pix) : TileSet(pix, horiz, endSize, middleSize);
+                itsPixmapCache.insert(key, tiles);
             }
 
-            if(small)
-                p->drawPixmap(r.topLeft(), pix);
-            else if(horiz)
-            {
-                int middle(qMin(r.width()-(2*endSize), middleSize));
-                if(middle>0)
-                    p->drawTiledPixmap(r.x()+endSize, r.y(), r.width()-(2*endSize), pix.height(), pix.copy(endSize, 0, middle, pix.height()));
-                p->drawPixmap(r.x(), r.y(), pix.copy(0, 0, endSize, pix.height()));
-                p->drawPixmap(r.x()+r.width()-endSize, r.y(), pix.copy(pix.width()-endSize, 0, endSize, pix.height()));
-            }
-            else
-            {
-                int middle(qMin(r.height()-(2*endSize), middleSize));
-                if(middle>0)
-                    p->drawTiledPixmap(r.x(), r.y()+endSize, pix.width(), r.height()-(2*endSize),
-                                       pix.copy(0, endSize, pix.width(), middle));
-                p->drawPixmap(r.x(), r.y(), pix.copy(0, 0, pix.width(), endSize));
-                p->drawPixmap(r.x(), r.y()+r.height()-endSize, pix.copy(0, pix.height()-endSize, pix.width(), endSize));
-            }
+            tiles.render(p, r);
 
             if(WIDGET_SB_SLIDER==w && opts.stripedSbar)
             {
@@ -11551,14 +11892,14 @@ void Style::drawBgndRing(QPainter &painter, int x, int y, int size, int size2, b
 QPixmap Style::drawStripes(const QColor &color, int opacity) const
 {
     QPixmap pix;
-    QString key;
     QColor  col(color);
 
     if(100!=opacity)
         col.setAlphaF(opacity/100.0);
 
-    key.sprintf("qtc-stripes-%x", col.rgba());
-    if(!itsUsePixmapCache || !QPixmapCache::find(key, pix))
+    QtcKey key(createStripesKey(col));
+
+    if(!itsPixmapCache.find(key, pix))
     {
         pix=QPixmap(QSize(64, 64));
 
@@ -11591,8 +11932,7 @@ QPixmap Style::drawStripes(const QColor &color, int opacity) const
         for(int i=2; i<pix.height()-1; i+=4)
             pixPainter.drawLine(0, i, pix.width()-1, i);
 
-        if(itsUsePixmapCache)
-            QPixmapCache::insert(key, pix);
+        itsPixmapCache.insert(key, pix);
     }
 
     return pix;
@@ -11606,11 +11946,9 @@ void Style::drawBackground(QPainter *p, const QColor &bgnd, const QRect &r, int
     if(!IS_FLAT_BGND(app))
     {
         static const int constPixmapWidth  = 16;
-        static const int constPixmapHeight = 512;
 
         QColor    col(bgnd);
         QPixmap   pix;
-        QSize     scaledSize;
         EGradType grad=isWindow ? opts.bgndGrad : opts.menuBgndGrad;
 
         if(APPEARANCE_STRIPED==app)
@@ -11619,49 +11957,45 @@ void Style::drawBackground(QPainter *p, const QColor &bgnd, const QRect &r, int
             pix=isWindow ? opts.bgndPixmap.img : opts.menuBgndPixmap.img;
         else
         {
-            QString key;
-
-            scaledSize=QSize(GT_HORIZ==grad ? constPixmapWidth : r.width(), GT_HORIZ==grad ? r.height() : constPixmapWidth);
+            // The strip is rendered, and cached, at the size needed - so that repaints are a straight blit, with no
+            // rescaling. As there is then an entry for every size a window is resized through, these are only kept
+            // in memory - and not stored in the shared, or disk, caches...
+            QSize stripSize(GT_HORIZ==grad ? constPixmapWidth : r.width(), GT_HORIZ==grad ? r.height() : constPixmapWidth);
 
             if(100!=opacity)
                 col.setAlphaF(opacity/100.0);
 
-            key.sprintf("qtc-bgnd-%x-%d-%d", col.rgba(), grad, app);
-            if(!itsUsePixmapCache || !QPixmapCache::find(key, pix))
+            QtcKey key(createBgndKey(col, grad, app, GT_HORIZ==grad ? stripSize.height() : stripSize.width()));
+
+            if(!itsPixmapCache.find(key, pix, false))
             {
-                pix=QPixmap(QSize(GT_HORIZ==grad ? constPixmapWidth : constPixmapHeight, GT_HORIZ==grad ? constPixmapHeight : constPixmapWidth));
+                pix=QPixmap(stripSize);
                 pix.fill(Qt::transparent);
 
                 QPainter pixPainter(&pix);
 
                 drawBevelGradientReal(col, &pixPainter, QRect(0, 0, pix.width(), pix.height()), GT_HORIZ==grad, false, app, WIDGET_OTHER);
                 pixPainter.end();
-                if(itsUsePixmapCache)
-                    QPixmapCache::insert(key, pix);
+                itsPixmapCache.insert(key, pix, false);
             }
         }
 
         if(path.isEmpty())
-            p->drawTiledPixmap(r, APPEARANCE_STRIPED==app || APPEARANCE_FILE==app || scaledSize==pix.size()
-                                    ? pix : pix.scaled(scaledSize, Qt::IgnoreAspectRatio));
+            p->drawTiledPixmap(r, pix);
         else
         {
             const QPointF prevOrigin(p->brushOrigin());
             p->setBrushOrigin(r.x(), r.y());
-            p->fillPath(path,
-                        QBrush(APPEARANCE_STRIPED==app || APPEARANCE_FILE==app || scaledSize==pix.size()
-                                ? pix : pix.scaled(scaledSize, Qt::IgnoreAspectRatio)));
+            p->fillPath(path, QBrush(pix));
             p->setBrushOrigin(prevOrigin);
         }
 
         if(isWindow && APPEARANCE_STRIPED!=app && APPEARANCE_FILE!=app && GT_HORIZ==grad && GB_SHINE==qtcGetGradient(app, &opts)->border)
         {
-            int size=qMin(BGND_SHINE_SIZE, qMin(r.height()*2, r.width()));
-
-            QString key;
-            key.sprintf("qtc-radial-%x", size/BGND_SHINE_STEPS);
+            int    size=qMin(BGND_SHINE_SIZE, qMin(r.height()*2, r.width()));
+            QtcKey key(createShineKey(col, size/BGND_SHINE_STEPS));
 
-            if(!itsUsePixmapCache || !QPixmapCache::find(key, pix))
+            if(!itsPixmapCache.find(key, pix))
             {
                 size/=BGND_SHINE_STEPS;
                 size*=BGND_SHINE_STEPS;
@@ -11682,8 +12016,7 @@ void Style::drawBackground(QPainter *p, const QColor &bgnd, const QRect &r, int
                 QPainter pixPainter(&pix);
                 pixPainter.fillRect(QRect(0, 0, pix.width(), pix.height()), gradient);
                 pixPainter.end();
-                if(itsUsePixmapCache)
-                    QPixmapCache::insert(key, pix);
+                itsPixmapCache.insert(key, pix);
             }
 
             p->drawPixmap(r.x()+((r.width()-pix.width())/2), r.y(), pix);
@@ -11723,7 +12056,8 @@ void Style::drawBackgroundImage(QPainter *p, bool isWindow, const QRect &r) cons
         case IMG_NONE:
             break;
         case IMG_FILE:
-            qtcLoadBgndImage(&img);
+            // Never load synchronously - if the image is not ready yet, the loader will update windows once it is.
+            itsBgndImageLoader->load(&img);
             if(!img.pixmap.img.isNull())
             {
                 switch(img.pos)
@@ -12562,7 +12896,7 @@ void Style::drawSbSliderHandle(QPainter *p, const QRect &rOrig, const QStyleOpti
         switch(opts.sliderThumbs)
         {
             case LINE_1DOT:
-                p->drawPixmap(r.x()+((r.width()-5)/2), r.y()+((r.height()-5)/2), *getPixmap(markers[STD_BORDER], PIX_DOT, 1.0));
+                p->drawPixmap(r.x()+((r.width()-5)/2), r.y()+((r.height()-5)/2), getPixmap(markers[STD_BORDER], PIX_DOT, 1.0));
                 break;
             case LINE_FLAT:
                 drawLines(p, r, !horiz, 3, 5, markers, 0, 5, opts.sliderThumbs);
@@ -12957,7 +13291,7 @@ void Style::drawHandleMarkers(QPainter *p, const QRect &rx, const QStyleOption *
         case LINE_NONE:
             break;
         case LINE_1DOT:
-             p->drawPixmap(r.x()+((r.width()-5)/2), r.y()+((r.height()-5)/2), *getPixmap(border[STD_BORDER], PIX_DOT, 1.0));
+             p->drawPixmap(r.x()+((r.width()-5)/2), r.y()+((r.height()-5)/2), getPixmap(border[STD_BORDER], PIX_DOT, 1.0));
             break;
         case LINE_DOTS:
             drawDots(p, r, !(option->state&State_Horizontal), 2, tb ? 5 : 3, border, tb ? -2 : 0, 5);
@@ -13019,16 +13353,30 @@ void Style::shadeColors(const QColor &base, QColor *vals) const
     SHADES
 
     bool   useCustom(USE_CUSTOM_SHADES(opts));
-    double hl=TO_FACTOR(opts.highlightFactor);
+    double hl=TO_FACTOR(opts.highlightFactor),
+           k[NUM_STD_SHADES+1];
 
+    // The standard shades, and SHADE_ORIG_HIGHLIGHT (which follows them), are all of the base colour - so
+    // shade these in one go...
     for(int i=0; i<NUM_STD_SHADES; ++i)
-        shade(base, &vals[i], useCustom ? opts.customShades[i] : SHADE(opts.contrast, i));
-    shade(base, &vals[SHADE_ORIG_HIGHLIGHT], hl);
+        k[i]=useCustom ? opts.customShades[i] : SHADE(opts.contrast, i);
+    k[NUM_STD_SHADES]=hl;
+    ::qtcShadeColors(&opts, base, k, NUM_STD_SHADES+1, vals);
     shade(vals[4], &vals[SHADE_4_HIGHLIGHT], hl);
     shade(vals[2], &vals[SHADE_2_HIGHLIGHT], hl);
     vals[ORIGINAL_SHADE]=base;
 }
 
+const QColor * Style::cachedShades(const QColor &base) const
+{
+    bool   hit;
+    QColor *cols=itsShadeCache.get(base.rgba(), opts.shading, &hit);
+
+    if(!hit)
+        shadeColors(base, cols);
+    return cols;
+}
+
 const QColor * Style::buttonColors(const QStyleOption *option) const
 {
    if(option && option->version>=TBAR_VERSION_HACK &&
@@ -13037,10 +13385,7 @@ const QColor * Style::buttonColors(const QStyleOption *option) const
         return itsTitleBarButtonsCols[option->version-TBAR_VERSION_HACK];
 
     if(option && option->palette.button()!=itsButtonCols[ORIGINAL_SHADE])
-    {
-        shadeColors(option->palette.button().color(), itsColoredButtonCols);
-        return itsColoredButtonCols;
-    }
+        return cachedShades(option->palette.button().color());
 
     return itsButtonCols;
 }
@@ -13084,10 +13429,7 @@ const QColor * Style::sliderColors(const QStyleOption *option) const
 const QColor * Style::backgroundColors(const QColor &col) const
 {
     if(col.alpha()!=0 && col!=itsBackgroundCols[ORIGINAL_SHADE])
-    {
-        shadeColors(col, itsColoredBackgroundCols);
-        return itsColoredBackgroundCols;
-    }
+        return cachedShades(col);
 
     return itsBackgroundCols;
 }
@@ -13095,10 +13437,7 @@ const QColor * Style::backgroundColors(const QColor &col) const
 const QColor * Style::highlightColors(const QColor &col) const
 {
     if(col.alpha()!=0 && col!=itsHighlightCols[ORIGINAL_SHADE])
-    {
-        shadeColors(col, itsColoredHighlightCols);
-        return itsColoredHighlightCols;
-    }
+        return cachedShades(col);
 
     return itsHighlightCols;
 }
@@ -13406,20 +13745,20 @@ const QColor & Style::getFill(const QStyleOption *option, const QColor *use, boo
                                : use[darker ? 2 : ORIGINAL_SHADE];
 }
 
-QPixmap * Style::getPixmap(const QColor col, EPixmap p, double shade) const
+QPixmap Style::getPixmap(const QColor col, EPixmap p, double shade) const
 {
     QtcKey  key(createKey(col, p));
-    QPixmap *pix=itsPixmapCache.object(key);
+    QPixmap pix;
 
-    if(!pix)
+    if(!itsPixmapCache.find(key, pix))
     {
         if(PIX_DOT==p)
         {
-            pix=new QPixmap(5, 5);
-            pix->fill(Qt::transparent);
+            pix=QPixmap(5, 5);
+            pix.fill(Qt::transparent);
 
             QColor          c(col);
-            QPainter        p(pix);
+            QPainter        p(&pix);
             QLinearGradient g1(0, 0, 5, 5),
                             g2(0, 0, 3, 3);
 
@@ -13441,8 +13780,6 @@ QPixmap * Style::getPixmap(const QColor col, EPixmap p, double shade) const
         }
         else
         {
-            pix=new QPixmap();
-
             QImage img;
 
             switch(p)
@@ -13461,9 +13798,9 @@ QPixmap * Style::getPixmap(const QColor col, EPixmap p, double shade) const
                 img=img.convertToFormat(QImage::Format_ARGB32);
 
             qtcAdjustPix(img.bits(), 4, img.width(), img.height(), img.bytesPerLine(), col.red(), col.green(), col.blue(), shade);
-            *pix=QPixmap::fromImage(img);
+            pix=QPixmap::fromImage(img);
         }
-        itsPixmapCache.insert(key, pix, pix->depth()/8);
+        itsPixmapCache.insert(key, pix);
     }
 
     return pix;
@@ -13680,8 +14017,6 @@ void Style::kdeGlobalSettingsChange(int type, int)
         case KGlobalSettings::StyleChanged:
         {
             KGlobal::config()->reparseConfiguration();
-            if(itsUsePixmapCache)
-                QPixmapCache::clear();
             init(false);
 
             QWidgetList                tlw=QApplication::topLevelWidgets();
@@ -13694,9 +14029,10 @@ void Style::kdeGlobalSettingsChange(int type, int)
         }
         case KGlobalSettings::PaletteChanged:
             KGlobal::config()->reparseConfiguration();
+            // Clear before applying, as clearing also closes the shared/disk caches - and re-polishing the palette
+            // then opens the ones for the new colours.
+            itsPixmapCache.clear();
             applyKdeSettings(true);
-            if(itsUsePixmapCache)
-                QPixmapCache::clear();
             break;
         case KGlobalSettings::FontChanged:
             KGlobal::config()->reparseConfiguration();
@@ -13913,6 +14249,17 @@ void Style::emitStatusBarState(QStatusBar *sb)
     }
 }
 
+// The KWin decoration caches the window's background and opacity properties, so tell it when these change.
+void Style::emitWindowPropertiesChanged(QWidget *w)
+{
+    if(w && canAccessId(w->window()))
+    {
+        if(!itsDBus)
+            itsDBus=new QDBusInterface("org.kde.kwin", "/QtCurve", "org.kde.QtCurve");
+        itsDBus->call(QDBus::NoBlock, "windowPropertiesChanged", (unsigned int)w->window()->winId());
+    }
+}
+
 #endif
 
 }
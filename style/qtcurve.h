@@ -34,9 +34,9 @@
 #if (QT_VERSION >= QT_VERSION_CHECK(4, 4, 0))
 #include <QFormLayout>
 #endif
-#include <Q_UINT64>
-typedef qulonglong QtcKey;
 #include "common.h"
+#include "pixmapcache.h"
+#include "shadecache.h"
 
 #if !defined QTC_QT_ONLY
 #include <KDE/KComponentData>
@@ -64,6 +64,7 @@ namespace QtCurve
     class WindowManager;
     class BlurHelper;
     class ShortcutHandler;
+    class BgndImageLoader;
 #ifdef Q_WS_X11
     class ShadowHelper;
 #endif
@@ -146,6 +147,7 @@ class Style : public QCommonStyle
     void freeColors();
 
     Options & options() { return opts; }
+    const ShadeCache & shadeCache() const { return itsShadeCache; }
 
     void polish(QApplication *app);
     void polish(QPalette &palette);
@@ -245,6 +247,7 @@ class Style : public QCommonStyle
     void fillTab(QPainter *p, const QRect &r, const QStyleOption *option, const QColor &fill, bool horiz, EWidget tab, bool tabOnly) const;
     void colorTab(QPainter *p, const QRect &r, bool horiz, EWidget tab, int round) const;
     void shadeColors(const QColor &base, QColor *vals) const;
+    const QColor * cachedShades(const QColor &base) const;
     const QColor * buttonColors(const QStyleOption *option) const;
     QColor         titlebarIconColor(const QStyleOption *option) const;
     const QColor * popupMenuCols(const QStyleOption *option=0L) const;
@@ -267,7 +270,7 @@ class Style : public QCommonStyle
     const QColor & getFill(const QStyleOption *option, const QColor *use, bool cr=false, bool darker=false) const;
     const QColor & getTabFill(bool current, bool highlight, const QColor *use) const;
     QColor         menuStripeCol() const;
-    QPixmap *      getPixmap(const QColor col, EPixmap p, double shade=1.0) const;
+    QPixmap        getPixmap(const QColor col, EPixmap p, double shade=1.0) const;
     int            konqMenuBarSize(const QMenuBar *menu) const;
     const QColor & checkRadioCol(const QStyleOption *opt) const;
     QColor         shade(const QColor &a, double k) const;
@@ -293,6 +296,14 @@ class Style : public QCommonStyle
 
     void           toggleMenuBar(QMainWindow *window);
     void           toggleStatusBar(QMainWindow *window);
+    bool           progressBarAnimates(const QProgressBar *bar) const;
+    bool           progressBarShowing(const QProgressBar *bar) const;
+    void           startProgressBarTimer();
+    QRect          progressBarAnimRect(const QProgressBar *bar, int step) const;
+    void           setupEventFilterTypes();
+#if defined QTC_ENABLE_DISK_TILE_CACHE || defined QTC_ENABLE_SHARED_TILE_CACHE
+    void           openTileCaches(const QPalette &palette);
+#endif
 
 #if !defined QTC_QT_ONLY
     void           setupKde4();
@@ -305,10 +316,13 @@ class Style : public QCommonStyle
     bool           isWindowDragWidget(QObject *o);
     void           emitMenuSize(QWidget *w, unsigned short size, bool force=false);
     void           emitStatusBarState(QStatusBar *sb);
+    void           emitWindowPropertiesChanged(QWidget *w);
 #endif
 
     private:
 
+    enum { constNumFilterEvents = 256 };
+
     mutable Options                    opts;
     QColor                             itsHighlightCols[TOTAL_SHADES+1],
                                        itsBackgroundCols[TOTAL_SHADES+1],
@@ -327,7 +341,6 @@ class Style : public QCommonStyle
                                        itsCheckRadioCol;
     bool                               itsSaveMenuBarStatus,
                                        itsSaveStatusBarStatus,
-                                       itsUsePixmapCache,
                                        itsInactiveChangeSelectionColor;
     PreviewType                        itsIsPreview;
     mutable QColor                     *itsSidebarButtonsCols;
@@ -335,10 +348,11 @@ class Style : public QCommonStyle
     mutable QColor                     *itsMdiColors;
     mutable QColor                     itsActiveMdiTextColor;
     mutable QColor                     itsMdiTextColor;
-    mutable QColor                     itsColoredButtonCols[TOTAL_SHADES+1];
-    mutable QColor                     itsColoredBackgroundCols[TOTAL_SHADES+1];
-    mutable QColor                     itsColoredHighlightCols[TOTAL_SHADES+1];
-    mutable QCache<QtcKey, QPixmap>    itsPixmapCache;
+    ShadeCache                         itsShadeCache;
+    PixmapCache                        itsPixmapCache;
+#if defined QTC_ENABLE_DISK_TILE_CACHE || defined QTC_ENABLE_SHARED_TILE_CACHE
+    QString                            itsConfigFile;
+#endif
     mutable bool                       itsActive;
     mutable const QWidget              *itsSbWidget;
     mutable QLabel                     *itsClickedLabel;
@@ -363,12 +377,17 @@ class Style : public QCommonStyle
 #endif
     mutable QScrollBar                 *itsSViewSBar;
     mutable QMap<QWidget *, QSet<QWidget *> > itsSViewContainers;
+    // The event types that eventFilter() acts on, and how many events of each type it has been sent (the last entry
+    // counts the types beyond the table, e.g. user events) - see setupEventFilterTypes()
+    bool                               itsFilterEvents[constNumFilterEvents];
+    unsigned long                      itsFilterCounts[constNumFilterEvents+1];
 #if !defined QTC_QT_ONLY
     KComponentData                     itsComponentData;
 #endif
     QtCurve::WindowManager             *itsWindowManager;
     QtCurve::BlurHelper                *itsBlurHelper;
     QtCurve::ShortcutHandler           *itsShortcutHandler;
+    QtCurve::BgndImageLoader           *itsBgndImageLoader;
 #ifdef QTC_STYLE_SUPPORT
     QString                            itsName;
 #endif
@@ -0,0 +1,98 @@
+#ifndef __QTC_SHADE_CACHE_H__
+#define __QTC_SHADE_CACHE_H__
+
+/*
+  QtCurve (C) Craig Drummond, 2007 - 2010 craig.p.drummond@gmail.com
+
+  ----
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public
+  License version 2 as published by the Free Software Foundation.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+  General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; see the file COPYING.  If not, write to
+  the Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+  Boston, MA 02110-1301, USA.
+*/
+
+#include <QtGui/QColor>
+#include "common.h"
+
+namespace QtCurve
+{
+    // Small LRU of shaded palettes (the TOTAL_SHADES+1 colours that shadeColors() derives from a base colour), so
+    // that widgets with their own palettes do not cause every paint to recompute the shades. Entries are never
+    // moved, so a returned palette stays valid until constSize other colours have been requested.
+    class ShadeCache
+    {
+        public:
+
+        enum { constSize = 16 };
+
+        ShadeCache() : itsClock(0), itsHits(0), itsMisses(0) { clear(); }
+
+        // Returns the palette for rgba/shading. On a miss, the least recently used entry is handed over to the
+        // new key and *hit is false - the caller must then fill in the colours.
+        QColor * get(QRgb rgba, int shading, bool *hit) const
+        {
+            Entry *lru=itsEntries;
+
+            ++itsClock;
+            for(int i=0; i<constSize; ++i)
+            {
+                Entry &e(itsEntries[i]);
+
+                if(e.used && e.rgba==rgba && e.shading==shading)
+                {
+                    e.used=itsClock;
+                    ++itsHits;
+                    *hit=true;
+                    return e.cols;
+                }
+                if(e.used<lru->used)
+                    lru=&e;
+            }
+
+            lru->rgba=rgba;
+            lru->shading=shading;
+            lru->used=itsClock;
+            ++itsMisses;
+            *hit=false;
+            return lru->cols;
+        }
+
+        // Drops all entries - the hit/miss counters are kept, as they cover the life of the style.
+        void clear() const
+        {
+            for(int i=0; i<constSize; ++i)
+                itsEntries[i].used=0;
+            itsClock=0;
+        }
+
+        unsigned long hits() const   { return itsHits; }
+        unsigned long misses() const { return itsMisses; }
+
+        private:
+
+        struct Entry
+        {
+            QRgb          rgba;
+            int           shading;
+            unsigned long used;
+            QColor        cols[TOTAL_SHADES+1];
+        };
+
+        mutable Entry         itsEntries[constSize];
+        mutable unsigned long itsClock,
+                              itsHits,
+                              itsMisses;
+    };
+}
+
+#endif
@@ -0,0 +1,300 @@
+/*
+  QtCurve (C) Craig Drummond, 2007 - 2010 craig.p.drummond@gmail.com
+
+  ----
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public
+  License version 2 as published by the Free Software Foundation.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+  General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; see the file COPYING.  If not, write to
+  the Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+  Boston, MA 02110-1301, USA.
+*/
+
+#include "sharedtilecache.h"
+#include <QtCore/QDir>
+#include <QtCore/QStringList>
+#include <QtCore/QSysInfo>
+#include <QtGui/QImage>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <string.h>
+#include <stdio.h>
+#include <time.h>
+
+namespace QtCurve
+{
+
+static const char    constMagic[8]    = { 'Q', 't', 'C', 'S', 'h', 'T', 'i', 'l' };
+static const quint32 constVersion     = 2;
+static const int     constSegmentSize = 8*1024*1024;
+static const int     constNumSlots    = 4096;
+static const int     constMaxProbe    = 16;
+static const int     constSlicedFlag  = 0x01;
+static const int     constHorizFlag   = 0x02;
+static const int     constInitTimeout = 10;             // Seconds
+static const int     constMaxUnused   = 7*24*60*60;     // Seconds
+
+enum EState
+{
+    STATE_EMPTY,
+    STATE_WRITING,  // Claimed by a process that is copying its tile in
+    STATE_READY,
+    STATE_FAILED    // Out of space - the slot stays claimed, so that lookups probe past it
+};
+
+static QByteArray segmentPrefix()
+{
+    // Per-user, as any process that can map the segment can write to it
+    return QByteArray("qtcurve-tiles-")+QByteArray::number((int)getuid())+'-';
+}
+
+static bool validHeader(const char *magic, quint32 version, quint32 byteOrder)
+{
+    return 0==memcmp(magic, constMagic, sizeof(constMagic)) && constVersion==version &&
+           (quint32)QSysInfo::ByteOrder==byteOrder;
+}
+
+// Remove any of this user's segments that have not been opened for constMaxUnused seconds. Segments are listed via
+// /dev/shm, so this only does anything where that is where they live (e.g. Linux).
+void SharedTileCache::removeUnused(const QByteArray &current)
+{
+    QByteArray  pattern(segmentPrefix()+'*');
+    QStringList segments(QDir(QLatin1String("/dev/shm")).entryList(QStringList() << QString::fromLatin1(pattern.constData()),
+                                                                  QDir::Files|QDir::System));
+    qint32      now(time(0L));
+
+    foreach(const QString &segment, segments)
+    {
+        QByteArray name('/'+segment.toLatin1());
+
+        if(name==current)
+            continue;
+
+        int fd=shm_open(name.constData(), O_RDONLY, 0);
+
+        if(-1==fd)
+            continue;
+
+        struct stat info;
+        bool        unused(false);
+
+        if(0==fstat(fd, &info))
+        {
+            // The header is only read - it may be being updated by another process, but at worst this means the
+            // segment is kept for now.
+            Header hdr;
+
+            memset(&hdr, 0, sizeof(hdr));
+            if(info.st_size<(off_t)sizeof(hdr) || sizeof(hdr)!=(size_t)pread(fd, &hdr, sizeof(hdr), 0) ||
+               !validHeader(hdr.magic, hdr.version, hdr.byteOrder))
+                unused=now-info.st_ctime>constMaxUnused;
+            else
+                unused=now-hdr.lastOpened>constMaxUnused;
+        }
+        ::close(fd);
+
+        if(unused)
+            shm_unlink(name.constData());
+    }
+}
+
+bool SharedTileCache::map(const char *name, bool &created)
+{
+    int fd=shm_open(name, O_RDWR|O_CREAT|O_EXCL, S_IRUSR|S_IWUSR);
+
+    created=-1!=fd;
+    if(!created)
+        fd=shm_open(name, O_RDWR, S_IRUSR|S_IWUSR);
+
+    if(-1==fd)
+        return false;
+
+    struct stat info;
+
+    // ftruncate() zero-fills, so a newly created segment starts with everything in STATE_EMPTY
+    if(0==fstat(fd, &info) && (info.st_size==constSegmentSize || 0==ftruncate(fd, constSegmentSize)))
+    {
+        void *data=mmap(0L, constSegmentSize, PROT_READ|PROT_WRITE, MAP_SHARED, fd, 0);
+
+        if(MAP_FAILED!=data)
+            itsData=(uchar *)data;
+    }
+
+    Header *hdr=header();
+    qint32 now(time(0L));
+
+    // If the segment was not initialised by whoever started to (because it crashed), or it is from an incompatible
+    // version, then remove it and let the caller create a new one. (A segment that is still STATE_EMPTY is simply
+    // initialised by open().)
+    if(itsData && !created &&
+       (STATE_READY==hdr->state
+           ? !validHeader(hdr->magic, hdr->version, hdr->byteOrder)
+           : STATE_WRITING==hdr->state &&
+                 now-(hdr->initTime ? hdr->initTime : (qint32)info.st_ctime)>constInitTimeout))
+    {
+        close();
+        shm_unlink(name);
+    }
+    ::close(fd);
+    return 0L!=itsData;
+}
+
+void SharedTileCache::open(const QString &hash)
+{
+    close();
+
+    QByteArray name('/'+segmentPrefix()+hash.toLatin1());
+    bool       created(false);
+
+    // A second attempt is made in case the first found, and removed, a broken segment
+    for(int i=0; i<2 && !itsData; ++i)
+        map(name.constData(), created);
+
+    if(!itsData)
+        return;
+
+    Header *hdr=header();
+
+    // Whichever process gets here first initialises the header, the others will skip the segment until it
+    // has done so...
+    if(__sync_bool_compare_and_swap(&hdr->state, STATE_EMPTY, STATE_WRITING))
+    {
+        hdr->initTime=time(0L);
+        memcpy(hdr->magic, constMagic, sizeof(constMagic));
+        hdr->version=constVersion;
+        hdr->byteOrder=QSysInfo::ByteOrder;
+        hdr->dataUsed=sizeof(Header)+(constNumSlots*sizeof(Slot));
+        __sync_synchronize();
+        hdr->state=STATE_READY;
+    }
+    hdr->lastOpened=time(0L);
+
+    if(created)
+        removeUnused(name);
+}
+
+void SharedTileCache::close()
+{
+    if(itsData)
+        munmap(itsData, constSegmentSize);
+    itsData=0L;
+}
+
+bool SharedTileCache::find(const QtcKey &key, TileSet &tiles) const
+{
+    if(!itsData || STATE_READY!=header()->state || 0!=memcmp(header()->magic, constMagic, sizeof(constMagic)) ||
+       constVersion!=header()->version || (quint32)QSysInfo::ByteOrder!=header()->byteOrder)
+        return false;
+
+    uint first(qHash(key)%constNumSlots);
+
+    for(int p=0; p<constMaxProbe; ++p)
+    {
+        const Slot *s=slot((first+p)%constNumSlots);
+        qint32     state(s->state);
+
+        if(STATE_EMPTY==state)
+            return false;
+
+        if(STATE_READY==state && s->high==key.high && s->low==key.low)
+        {
+            // Pairs with the barrier before publishing in add() - the slot contents are complete.
+            __sync_synchronize();
+            tiles=s->flags&constSlicedFlag
+                    ? TileSet(pixmap(s->images[0]), pixmap(s->images[1]), pixmap(s->images[2]),
+                              s->flags&constHorizFlag, s->endSize)
+                    : TileSet(pixmap(s->images[1]));
+            return true;
+        }
+    }
+    return false;
+}
+
+void SharedTileCache::add(const QtcKey &key, const TileSet &tiles)
+{
+    if(!itsData || STATE_READY!=header()->state)
+        return;
+
+    uint first(qHash(key)%constNumSlots);
+
+    for(int p=0; p<constMaxProbe; ++p)
+    {
+        Slot   *s=slot((first+p)%constNumSlots);
+        qint32 state(s->state);
+
+        if(STATE_READY==state && s->high==key.high && s->low==key.low)
+            return;
+
+        if(STATE_EMPTY==state && __sync_bool_compare_and_swap(&s->state, STATE_EMPTY, STATE_WRITING))
+        {
+            bool ok(true);
+
+            s->high=key.high;
+            s->low=key.low;
+            s->flags=0;
+            s->endSize=0;
+            memset(s->images, 0, sizeof(s->images));
+            if(tiles.isSliced())
+            {
+                s->flags=constSlicedFlag|(tiles.isHorizontal() ? constHorizFlag : 0);
+                s->endSize=tiles.endSize();
+                ok=storeImage(tiles.start().toImage().convertToFormat(QImage::Format_ARGB32_Premultiplied), s->images[0]) &&
+                   storeImage(tiles.end().toImage().convertToFormat(QImage::Format_ARGB32_Premultiplied), s->images[2]);
+            }
+            ok=ok && storeImage(tiles.pixmap().toImage().convertToFormat(QImage::Format_ARGB32_Premultiplied), s->images[1]);
+
+            // Make sure the contents are visible to other processes before the slot is
+            __sync_synchronize();
+            s->state=ok ? STATE_READY : STATE_FAILED;
+            return;
+        }
+    }
+}
+
+bool SharedTileCache::storeImage(const QImage &img, Image &entry)
+{
+    int bytes(img.width()*img.height()*4);
+
+    if(bytes<=0)
+        return true;
+
+    // Lock-free bump allocation. The first check stops dataUsed growing without bound once the segment is
+    // full, the second catches processes that raced past the first.
+    if(header()->dataUsed+bytes>constSegmentSize)
+        return false;
+
+    qint32 offset(__sync_fetch_and_add(&header()->dataUsed, bytes));
+
+    if(offset+bytes>constSegmentSize)
+        return false;
+
+    for(int y=0; y<img.height(); ++y)
+        memcpy(itsData+offset+(y*img.width()*4), img.constScanLine(y), img.width()*4);
+
+    entry.width=img.width();
+    entry.height=img.height();
+    entry.offset=offset;
+    return true;
+}
+
+QPixmap SharedTileCache::pixmap(const Image &img) const
+{
+    if(0==img.width || 0==img.height ||
+       (qint64)img.offset+((qint64)img.width*img.height*4)>constSegmentSize)
+        return QPixmap();
+
+    return QPixmap::fromImage(QImage(itsData+img.offset, img.width, img.height, img.width*4,
+                                     QImage::Format_ARGB32_Premultiplied));
+}
+
+}
@@ -0,0 +1,100 @@
+#ifndef __QTC_SHARED_TILE_CACHE_H__
+#define __QTC_SHARED_TILE_CACHE_H__
+
+/*
+  QtCurve (C) Craig Drummond, 2007 - 2010 craig.p.drummond@gmail.com
+
+  ----
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public
+  License version 2 as published by the Free Software Foundation.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+  General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; see the file COPYING.  If not, write to
+  the Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+  Boston, MA 02110-1301, USA.
+*/
+
+#include <QtCore/QByteArray>
+#include <QtCore/QString>
+#include "qtckey.h"
+#include "tileset.h"
+
+class QImage;
+
+namespace QtCurve
+{
+    // Tiles shared between all of a user's QtCurve processes that use the same theme, via a POSIX shared memory
+    // segment named after the theme hash (see Style::openTileCaches()). The first process to render a tile
+    // stores it, and the others just copy it out. Slots and pixel data are allocated with atomic operations
+    // only, so no process ever blocks on another - at worst, two processes race to store the same tile and both
+    // copies are kept. Once the segment is full, new tiles are simply not shared.
+    //
+    // A process switching to a new theme hash does not unlink the old segment, as others may still be using it (the
+    // hash includes the palette, so a single app setting its own colours would otherwise unlink the segment for
+    // every other app). Instead, creating a segment removes any of the user's segments that have not been opened
+    // for a while - e.g. those for old themes, or for per-application settings of apps that have not been run since
+    // the theme changed. A segment whose initialisation never completed (i.e. the process crashed) is recreated.
+    class SharedTileCache
+    {
+        public:
+
+        SharedTileCache() : itsData(0L) { }
+        ~SharedTileCache() { close(); }
+
+        void open(const QString &hash);
+        // Unmaps the segment - it is not unlinked, as other processes may be using it (or may use it later).
+        void close();
+        bool isOpen() const { return 0L!=itsData; }
+
+        bool find(const QtcKey &key, TileSet &tiles) const;
+        void add(const QtcKey &key, const TileSet &tiles);
+
+        private:
+
+        struct Image
+        {
+            quint32 width,
+                    height,
+                    offset;
+        };
+
+        struct Slot
+        {
+            volatile qint32 state;
+            quint32         flags;
+            quint64         high,
+                            low;
+            quint32         endSize;
+            Image           images[3];  // start, middle, end - only middle is used for unsliced sets
+        };
+
+        struct Header
+        {
+            char            magic[8];
+            quint32         version,
+                            byteOrder;
+            volatile qint32 state,
+                            dataUsed;
+            qint32          initTime,   // When initialisation started, to detect a process crashing during it
+                            lastOpened; // Used to remove unused segments
+        };
+
+        Header *    header() const { return (Header *)itsData; }
+        Slot *      slot(int i) const { return ((Slot *)(itsData+sizeof(Header)))+i; }
+        QPixmap     pixmap(const Image &img) const;
+        bool        storeImage(const QImage &img, Image &entry);
+        bool        map(const char *name, bool &created);
+        static void removeUnused(const QByteArray &current);
+
+        uchar *itsData;
+    };
+}
+
+#endif
@@ -0,0 +1,94 @@
+/*
+  QtCurve (C) Craig Drummond, 2007 - 2010 craig.p.drummond@gmail.com
+
+  ----
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public
+  License version 2 as published by the Free Software Foundation.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+  General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; see the file COPYING.  If not, write to
+  the Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+  Boston, MA 02110-1301, USA.
+*/
+
+#include "tileset.h"
+#include <QtGui/QPainter>
+
+namespace QtCurve
+{
+
+// Middle tiles narrower than this are pre-tiled up to it, so that long widgets need fewer blits
+static const int constMinMiddleSize = 32;
+
+static int pixCost(const QPixmap &pix)
+{
+    return pix.width()*pix.height()*(pix.depth()/8);
+}
+
+TileSet::TileSet(const QPixmap &pix, bool horiz, int endSize, int middleSize)
+       : itsEndSize(endSize),
+         itsHoriz(horiz)
+{
+    int tiled(middleSize);
+
+    while(middleSize>0 && tiled<constMinMiddleSize)
+        tiled+=middleSize;
+
+    if(horiz)
+    {
+        itsStart=pix.copy(0, 0, endSize, pix.height());
+        itsEnd=pix.copy(pix.width()-endSize, 0, endSize, pix.height());
+        itsMiddle=QPixmap(tiled, pix.height());
+    }
+    else
+    {
+        itsStart=pix.copy(0, 0, pix.width(), endSize);
+        itsEnd=pix.copy(0, pix.height()-endSize, pix.width(), endSize);
+        itsMiddle=QPixmap(pix.width(), tiled);
+    }
+
+    itsMiddle.fill(Qt::transparent);
+
+    QPainter p(&itsMiddle);
+
+    p.drawTiledPixmap(itsMiddle.rect(), horiz ? pix.copy(endSize, 0, middleSize, pix.height())
+                                              : pix.copy(0, endSize, pix.width(), middleSize));
+}
+
+int TileSet::cost() const
+{
+    return pixCost(itsStart)+pixCost(itsMiddle)+pixCost(itsEnd);
+}
+
+void TileSet::render(QPainter *p, const QRect &r) const
+{
+    if(!isSliced())
+        p->drawPixmap(r.topLeft(), itsMiddle);
+    else if(itsHoriz)
+    {
+        int middle(r.width()-(2*itsEndSize));
+
+        if(middle>0)
+            p->drawTiledPixmap(r.x()+itsEndSize, r.y(), middle, itsMiddle.height(), itsMiddle);
+        p->drawPixmap(r.x(), r.y(), itsStart);
+        p->drawPixmap(r.x()+r.width()-itsEndSize, r.y(), itsEnd);
+    }
+    else
+    {
+        int middle(r.height()-(2*itsEndSize));
+
+        if(middle>0)
+            p->drawTiledPixmap(r.x(), r.y()+itsEndSize, itsMiddle.width(), middle, itsMiddle);
+        p->drawPixmap(r.x(), r.y(), itsStart);
+        p->drawPixmap(r.x(), r.y()+r.height()-itsEndSize, itsEnd);
+    }
+}
+
+}
@@ -0,0 +1,64 @@
+#ifndef __QTC_TILESET_H__
+#define __QTC_TILESET_H__
+
+/*
+  QtCurve (C) Craig Drummond, 2007 - 2010 craig.p.drummond@gmail.com
+
+  ----
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public
+  License version 2 as published by the Free Software Foundation.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+  General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; see the file COPYING.  If not, write to
+  the Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+  Boston, MA 02110-1301, USA.
+*/
+
+#include <QtGui/QPixmap>
+#include <QtCore/QRect>
+
+class QPainter;
+
+namespace QtCurve
+{
+    // A pixmap pre-sliced into start, middle and end tiles - a one-dimensional version of kwin's TileSet.
+    // Rendering into a rect of any length is then just blits, with no QPixmap::copy() per paint. An unsliced
+    // set just holds the whole pixmap, which is drawn as-is.
+    class TileSet
+    {
+        public:
+
+        TileSet() : itsEndSize(0), itsHoriz(true) { }
+        explicit TileSet(const QPixmap &pix) : itsMiddle(pix), itsEndSize(0), itsHoriz(true) { }
+        TileSet(const QPixmap &pix, bool horiz, int endSize, int middleSize);
+        // Re-create an already sliced set, e.g. as read back from the disk cache.
+        TileSet(const QPixmap &start, const QPixmap &middle, const QPixmap &end, bool horiz, int endSize)
+            : itsStart(start), itsMiddle(middle), itsEnd(end), itsEndSize(endSize), itsHoriz(horiz) { }
+
+        bool            isSliced() const     { return itsEndSize>0; }
+        bool            isHorizontal() const { return itsHoriz; }
+        int             endSize() const      { return itsEndSize; }
+        const QPixmap & start() const        { return itsStart; }
+        const QPixmap & pixmap() const       { return itsMiddle; }
+        const QPixmap & end() const          { return itsEnd; }
+        int             cost() const;
+        void            render(QPainter *p, const QRect &r) const;
+
+        private:
+
+        QPixmap itsStart,
+                itsMiddle,
+                itsEnd;
+        int     itsEndSize;
+        bool    itsHoriz;
+    };
+}
+
+#endif
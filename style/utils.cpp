@@ -24,6 +24,10 @@
 #ifdef Q_WS_X11
 #include <X11/Xlib.h>
 #include <X11/Xatom.h>
+#ifdef QTC_HAVE_XFIXES
+#include <X11/extensions/Xfixes.h>
+#include <QtGui/QApplication>
+#endif
 #include "fixx11h.h"
 #include <QX11Info>
 #endif
@@ -40,10 +44,9 @@ namespace QtCurve
 {
     namespace Utils
     {
-        bool compositingActive()
+        #if (defined QTC_QT_ONLY || !KDE_IS_VERSION(4, 4, 0)) && defined Q_WS_X11
+        static Atom compositingAtom()
         {
-            #if defined QTC_QT_ONLY || !KDE_IS_VERSION(4, 4, 0)
-            #ifdef Q_WS_X11
             static bool haveAtom=false;
             static Atom atom;
             if(!haveAtom)
@@ -56,8 +59,86 @@ namespace QtCurve
                 atom = XInternAtom(dpy, string, False);
                 haveAtom=true;
             }
+            return atom;
+        }
+
+        #ifdef QTC_HAVE_XFIXES
+        // If the X server has XFixes, then we ask to be told whenever the owner of the compositing manager selection
+        // changes - and so only need to query the owner once, rather than on every call (i.e. every window paint).
+        // The notifications are selected for a hidden helper window, so that Qt delivers them to its x11Event() -
+        // unlike a dispatcher event filter, this cannot be dropped by someone else replacing the filter.
+        enum EWatchState
+        {
+            WATCH_UNKNOWN,
+            WATCH_ACTIVE,
+            WATCH_UNAVAILABLE
+        };
+
+        static EWatchState theWatchState=WATCH_UNKNOWN;
+        static int         theXFixesEventBase=0;
+        static bool        theCompositingActive=false;
 
-            return XGetSelectionOwner(QX11Info::display(), atom) != None;
+        class CompositingWatcher : public QWidget
+        {
+            public:
+
+            CompositingWatcher() { setAttribute(Qt::WA_NativeWindow); }
+            // If the widget is ever deleted (e.g. on application exit), fall back to querying the owner.
+            ~CompositingWatcher() { theWatchState=WATCH_UNAVAILABLE; }
+
+            protected:
+
+            bool x11Event(XEvent *ev)
+            {
+                if(theXFixesEventBase+XFixesSelectionNotify==ev->type)
+                {
+                    XFixesSelectionNotifyEvent *sev=(XFixesSelectionNotifyEvent *)ev;
+
+                    // For the window-destroy and client-close notifications, the selection no longer has an owner.
+                    if(sev->selection==compositingAtom())
+                        theCompositingActive=XFixesSetSelectionOwnerNotify==sev->subtype && None!=sev->owner;
+                    return true;
+                }
+                return QWidget::x11Event(ev);
+            }
+        };
+
+        static bool watchCompositingManager()
+        {
+            if(WATCH_UNKNOWN==theWatchState)
+            {
+                Display *dpy=QX11Info::display();
+                int     errorBase;
+
+                if(!qApp || !XFixesQueryExtension(dpy, &theXFixesEventBase, &errorBase))
+                    theWatchState=WATCH_UNAVAILABLE;
+                else
+                {
+                    CompositingWatcher *watcher=new CompositingWatcher;
+
+                    XFixesSelectSelectionInput(dpy, watcher->winId(), compositingAtom(),
+                                               XFixesSetSelectionOwnerNotifyMask|XFixesSelectionWindowDestroyNotifyMask|
+                                               XFixesSelectionClientCloseNotifyMask);
+                    // Query after selecting the input, so that a change cannot be missed...
+                    theCompositingActive=XGetSelectionOwner(dpy, compositingAtom()) != None;
+                    theWatchState=WATCH_ACTIVE;
+                }
+            }
+
+            return WATCH_ACTIVE==theWatchState;
+        }
+        #endif // QTC_HAVE_XFIXES
+        #endif
+
+        bool compositingActive()
+        {
+            #if defined QTC_QT_ONLY || !KDE_IS_VERSION(4, 4, 0)
+            #ifdef Q_WS_X11
+            #ifdef QTC_HAVE_XFIXES
+            if(watchCompositingManager())
+                return theCompositingActive;
+            #endif
+            return XGetSelectionOwner(QX11Info::display(), compositingAtom()) != None;
             #else // Q_WS_X11
             return false;
             #endif // Q_WS_X11
@@ -0,0 +1,212 @@
+#ifndef __QTC_WIDGET_CLASS_H__
+#define __QTC_WIDGET_CLASS_H__
+
+/*
+  QtCurve (C) Craig Drummond, 2007 - 2010 craig.p.drummond@gmail.com
+
+  ----
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public
+  License version 2 as published by the Free Software Foundation.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+  General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; see the file COPYING.  If not, write to
+  the Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+  Boston, MA 02110-1301, USA.
+*/
+
+#include <QtCore/QByteArray>
+#include <QtCore/QHash>
+#include <QtCore/QObject>
+#include <string.h>
+
+namespace QtCurve
+{
+    // The classes of widget that the style special-cases. Each is matched as QObject::inherits() would - i.e.
+    // against the names of the class and all of its super classes - and several names may map to the same
+    // entry. Must stay below 64 entries.
+    enum WidgetClass
+    {
+        WC_HOVER,                       // Widgets that get WA_Hover when mouse-over is enabled
+        WC_TOOLBAR,                     // QToolBar or Q3ToolBar
+        WC_DIALOG,
+        WC_MAIN_WINDOW,
+        WC_MENUBAR,
+        WC_SCROLL_AREA,                 // QAbstractScrollArea
+        WC_ITEM_VIEW,                   // QAbstractItemView
+        WC_COMBO_CONTAINER,             // QComboBoxPrivateContainer
+        WC_COMBO_LIST_VIEW,             // QComboBoxListView
+        WC_DOCK_TITLE_BUTTON,           // QDockWidgetTitleButton
+        WC_TIP_LABEL,
+        WC_WHATS_THAT,
+        WC_SPLASH_SCREEN,
+        WC_TOOLBOX,
+        WC_TOOLBAR_EXTENSION,
+        WC_PRINT_PROPERTIES_DIALOG,
+        WC_DESIGNER_MENUBAR,
+        WC_QWEBVIEW,
+        WC_WEBVIEW,                     // Arora's WebView
+        WC_Q3_HEADER,
+        WC_Q3_SCROLLVIEW,
+        WC_Q3_COMBOBOX,
+        WC_Q3_MAIN_WINDOW,
+        WC_KFILE_PLACES_VIEW,
+        WC_KFILE_WIDGET,
+        WC_KFILE_DIALOG,
+        WC_KTITLE_WIDGET,
+        WC_KTABBAR,
+        WC_KMULTITABBAR_TAB,
+        WC_KMENU,
+        WC_KXMLGUI_WINDOW,
+        WC_KURL_BUTTON,
+        WC_KSCREENSAVER,
+        WC_KINTNUMINPUT,
+        WC_KHBOX,
+        WC_KCOLOR_PATCH,
+        WC_KABOUT_APPLICATION_DIALOG,
+        WC_KPAGE_LIST_VIEW,
+        WC_KO_DOCK_TITLE_BAR,           // KOffice's KoDockWidgetTitleBar
+        WC_KATE_VIEW,
+        WC_KMREADER_WIN,
+        WC_KMAIL_FOLDER_VIEW,
+        WC_KMAIL_MESSAGE_LIST,
+        WC_KPIM_TRANSACTION_VIEW,
+        WC_KONSOLE_MAIN_WINDOW,
+        WC_DOLPHIN_STATUSBAR,
+        WC_K3B_THEMED_HEADER,
+        WC_KDEV_IDEAL_BUTTON,
+        WC_KDEV_IDEAL_BUTTON_BAR
+    };
+
+    // Maps each QMetaObject to the set of WidgetClass entries it matches. This is worked out once per class (re-using
+    // the super class's set), so that checking a widget is a single hash lookup rather than a chain of qobject_cast
+    // and inherits() string compares. As a plugin may be unloaded, and another library loaded at the same address,
+    // the class name is also stored, and checked on a hit.
+    class WidgetClassCache
+    {
+        public:
+
+        bool is(const QObject *o, WidgetClass c) const
+        {
+            return o && (classes(o->metaObject())&(Q_UINT64_C(1)<<c));
+        }
+
+        quint64 classes(const QMetaObject *mo) const
+        {
+            QHash<const QMetaObject *, Entry>::ConstIterator it(itsClasses.constFind(mo));
+
+            if(it!=itsClasses.constEnd() && 0==strcmp(it.value().name.constData(), mo->className()))
+                return it.value().classes;
+
+            Entry entry;
+
+            entry.name=mo->className();
+            entry.classes=classify(mo->className()) | (mo->superClass() ? classes(mo->superClass()) : 0);
+            itsClasses.insert(mo, entry);
+            return entry.classes;
+        }
+
+        void clear() { itsClasses.clear(); }
+
+        private:
+
+        struct Entry
+        {
+            QByteArray name;
+            quint64    classes;
+        };
+
+        static quint64 classify(const char *className)
+        {
+            static const struct
+            {
+                const char  *name;
+                WidgetClass c;
+            } constNames[]=
+            {
+                { "QAbstractButton",                WC_HOVER },
+                { "QComboBox",                      WC_HOVER },
+                { "QAbstractSpinBox",               WC_HOVER },
+                { "QGroupBox",                      WC_HOVER },
+                { "QSplitterHandle",                WC_HOVER },
+                { "QSlider",                        WC_HOVER },
+                { "QHeaderView",                    WC_HOVER },
+                { "QTabBar",                        WC_HOVER },
+                { "QAbstractScrollArea",            WC_HOVER },
+                { "QTextEdit",                      WC_HOVER },
+                { "QLineEdit",                      WC_HOVER },
+                { "QDial",                          WC_HOVER },
+                { "QWorkspaceTitleBar",             WC_HOVER },
+                { "QDockSeparator",                 WC_HOVER },
+                { "QDockWidgetSeparator",           WC_HOVER },
+                { "Q3DockWindowResizeHandle",       WC_HOVER },
+                { "QToolBar",                       WC_TOOLBAR },
+                { "Q3ToolBar",                      WC_TOOLBAR },
+                { "QDialog",                        WC_DIALOG },
+                { "QMainWindow",                    WC_MAIN_WINDOW },
+                { "QMenuBar",                       WC_MENUBAR },
+                { "QAbstractScrollArea",            WC_SCROLL_AREA },
+                { "QAbstractItemView",              WC_ITEM_VIEW },
+                { "QComboBoxPrivateContainer",      WC_COMBO_CONTAINER },
+                { "QComboBoxListView",              WC_COMBO_LIST_VIEW },
+                { "QDockWidgetTitleButton",         WC_DOCK_TITLE_BUTTON },
+                { "QTipLabel",                      WC_TIP_LABEL },
+                { "QWhatsThat",                     WC_WHATS_THAT },
+                { "QSplashScreen",                  WC_SPLASH_SCREEN },
+                { "QToolBox",                       WC_TOOLBOX },
+                { "QToolBarExtension",              WC_TOOLBAR_EXTENSION },
+                { "QPrintPropertiesDialog",         WC_PRINT_PROPERTIES_DIALOG },
+                { "QDesignerMenuBar",               WC_DESIGNER_MENUBAR },
+                { "QWebView",                       WC_QWEBVIEW },
+                { "WebView",                        WC_WEBVIEW },
+                { "Q3Header",                       WC_Q3_HEADER },
+                { "Q3ScrollView",                   WC_Q3_SCROLLVIEW },
+                { "Q3ComboBox",                     WC_Q3_COMBOBOX },
+                { "Q3MainWindow",                   WC_Q3_MAIN_WINDOW },
+                { "KFilePlacesView",                WC_KFILE_PLACES_VIEW },
+                { "KFileWidget",                    WC_KFILE_WIDGET },
+                { "KFileDialog",                    WC_KFILE_DIALOG },
+                { "KTitleWidget",                   WC_KTITLE_WIDGET },
+                { "KTabBar",                        WC_KTABBAR },
+                { "KMultiTabBarTab",                WC_KMULTITABBAR_TAB },
+                { "KMenu",                          WC_KMENU },
+                { "KXmlGuiWindow",                  WC_KXMLGUI_WINDOW },
+                { "KUrlButton",                     WC_KURL_BUTTON },
+                { "KScreenSaver",                   WC_KSCREENSAVER },
+                { "KIntNumInput",                   WC_KINTNUMINPUT },
+                { "KHBox",                          WC_KHBOX },
+                { "KColorPatch",                    WC_KCOLOR_PATCH },
+                { "KAboutApplicationDialog",        WC_KABOUT_APPLICATION_DIALOG },
+                { "KDEPrivate::KPageListView",      WC_KPAGE_LIST_VIEW },
+                { "KoDockWidgetTitleBar",           WC_KO_DOCK_TITLE_BAR },
+                { "KateView",                       WC_KATE_VIEW },
+                { "KMReaderWin",                    WC_KMREADER_WIN },
+                { "KMail::MainFolderView",          WC_KMAIL_FOLDER_VIEW },
+                { "MessageList::Core::View",        WC_KMAIL_MESSAGE_LIST },
+                { "KPIM::TransactionItemView",      WC_KPIM_TRANSACTION_VIEW },
+                { "Konsole::MainWindow",            WC_KONSOLE_MAIN_WINDOW },
+                { "DolphinStatusBar",               WC_DOLPHIN_STATUSBAR },
+                { "K3b::ThemedHeader",              WC_K3B_THEMED_HEADER },
+                { "Sublime::IdealToolButton",       WC_KDEV_IDEAL_BUTTON },
+                { "Sublime::IdealButtonBarWidget",  WC_KDEV_IDEAL_BUTTON_BAR }
+            };
+
+            quint64 c(0);
+
+            for(unsigned int i=0; i<sizeof(constNames)/sizeof(constNames[0]); ++i)
+                if(0==strcmp(className, constNames[i].name))
+                    c|=Q_UINT64_C(1)<<constNames[i].c;
+            return c;
+        }
+
+        mutable QHash<const QMetaObject *, Entry> itsClasses;
+    };
+}
+
+#endif